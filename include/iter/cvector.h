@@ -0,0 +1,160 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_CVECTOR_H
+#define LIBITER_CVECTOR_H
+
+#include <iter/error.h>
+#include <iter/generic.h>
+#include <iter/vector.h>
+
+typedef struct allocator_t allocator_t;
+#include <stddef.h>
+
+#ifndef ITER_API
+    #define ITER_API
+#endif
+
+#ifndef ITER_INLINE
+    #define ITER_INLINE static inline
+#endif
+
+/** # cvector(T) - Concurrent append-only vectors
+
+    cvector(T) is an append-only array that can be pushed into from multiple
+    threads at the same time without locking. Producers reserve their range
+    of indexes with a single atomic addition and copy their items in place.
+
+    Items are stored in segments that double in size and are never moved,
+    which means that pointers returned by `cvector_get` stay valid until
+    the vector is sealed or destroyed, even while other threads are pushing.
+
+    Once all producers are done, `cvector_seal` turns the vector into
+    a regular, contiguous `vector(T)`.
+
+    > The allocator used by the vector must be thread-safe.
+**/
+
+#define cvector(T) generic_container(cvector_t, size_t, T)
+
+#define CVECTOR_SEGMENTS (sizeof(size_t) * 8)
+
+typedef struct cvector_t {
+    size_t length;
+    size_t stride;
+    size_t first;
+    allocator_t *allocator;
+    void *segments[CVECTOR_SEGMENTS];
+} cvector_t;
+
+#define cvector_type(m_cv) generic_value_type(cvector_t, m_cv)
+#define cvector_type_ptr(m_cv) generic_value_ptr(cvector_t, m_cv)
+#define cvector_type_size(m_cv) generic_value_size(cvector_t, m_cv)
+#define cvector_as_base(m_cv) generic_check_container(cvector_t, size_t, m_cv)
+#define cvector_check_type(m_cv, m_item)         \
+    generic_check_value(cvector_t, m_cv, m_item)
+
+/** cvector(T) cvector_create(type T, allocator_t *allocator);
+
+    Creates a new instance of `cvector(T)`, allocated with `allocator`.
+    Returns `NULL` if out of memory or `sizeof(T) == 0`.
+
+    > If `allocator` is `NULL`, the default one will be used.
+**/
+#define cvector_create(T, m_allocator)                      \
+    ((cvector(T))cvector__create(0, (m_allocator), sizeof(T)))
+
+/** cvector(T) cvector_with_capacity(type T, size_t cap, allocator_t *alloc);
+
+    Creates a new instance of `cvector(T)` whose first segment fits at
+    least `cap` items. Vectors that never outgrow their first segment
+    are sealed without copying. Returns `NULL` if out of memory.
+**/
+#define cvector_with_capacity(T, m_capacity, m_allocator)               \
+    ((cvector(T))cvector__create((m_capacity), (m_allocator), sizeof(T)))
+
+ITER_API cvector_t *cvector__create(
+    size_t capacity, allocator_t *allocator, size_t stride
+);
+
+/** void cvector_destroy(cvector(T) cv);
+
+    Frees all resources used by `cv` if it's not `NULL`.
+    This function must not be called while other threads are using `cv`.
+**/
+#define cvector_destroy(m_cv) cvector__destroy(cvector_as_base(m_cv))
+ITER_API void cvector__destroy(cvector_t *cv);
+
+/** size_t cvector_length(cvector(T) cv);
+
+    Returns number of items reserved in `cv` or 0 if `cv` is `NULL`.
+
+    > Items reserved by a concurrent `cvector_push` might not be written yet.
+**/
+#define cvector_length(m_cv) cvector__length(cvector_as_base(m_cv))
+
+ITER_INLINE size_t cvector__length(const cvector_t *cv) {
+    return cv ? __atomic_load_n(&cv->length, __ATOMIC_ACQUIRE) : 0;
+}
+
+/** int cvector_push(
+        cvector(T) cv,
+        const T *items,
+        size_t count,
+        size_t *index
+    );
+
+    Appends `count` items from `items` to the end of `cv`. This function can
+    be called from multiple threads at once. If `index` is not `NULL`, the
+    index of the first appended item is stored in it.
+
+    If out of memory, the reserved range is left in place and reads as
+    zeroed items after the vector has been sealed, since storage is zeroed
+    when it's allocated.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define cvector_push(m_cv, m_items, m_count, m_index) \
+    cvector__push(                                    \
+        cvector_as_base(m_cv),                        \
+        cvector_check_type(m_cv, m_items),            \
+        (m_count),                                    \
+        (m_index)                                     \
+    )
+
+ITER_API int cvector__push(
+    cvector_t *cv, const void *items, size_t count, size_t *index
+);
+
+/** T *cvector_get(cvector(T) cv, size_t i);
+
+    Returns pointer to the item at index `i` or `NULL` if out of bounds.
+    The item is only guaranteed to be written if the push that reserved it
+    has returned before this call, e.g. in the same thread or after a join.
+
+    > This pointer is valid until `cv` is sealed or destroyed.
+**/
+#define cvector_get(m_cv, m_i)                                         \
+    ((cvector_type_ptr(m_cv))cvector__get(cvector_as_base(m_cv), (m_i)))
+
+ITER_API void *cvector__get(const cvector_t *cv, size_t i);
+
+/** vector(T) cvector_seal(cvector(T) cv);
+
+    Moves all items of `cv` into a new `vector(T)` and destroys `cv`.
+    If every item fits into the first segment, its buffer is reused
+    and no copying is done. If out of memory, `NULL` is returned
+    and `cv` is left intact.
+
+    > This function must only be called after all producers are done.
+**/
+#define cvector_seal(m_cv)                                                 \
+    ((vector(cvector_type(m_cv)))cvector__seal(cvector_as_base(m_cv)))
+
+ITER_API vector_t *cvector__seal(cvector_t *cv);
+
+#endif
@@ -22,6 +22,7 @@
     - `ITER_ENOENT` - Key or value doesn't exist.
     - `ITER_ENODATA` - No more items available.
     - `ITER_ENOSYS` - Feature is not available.
+    - `ITER_EIO` - Reading or writing a file failed.
 
     Alongside these, boolean values `ITER_TRUE` and `ITER_FALSE` are defined.
 **/
@@ -35,6 +36,7 @@ enum {
     ITER_OK = 0,
     ITER_ENOENT = -2,
     ITER_EINTR = -4,
+    ITER_EIO = -5,
     ITER_ENOMEM = -12,
     ITER_EEXIST = -17,
     ITER_EINVAL = -22,
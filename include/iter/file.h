@@ -0,0 +1,153 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_FILE_H
+#define LIBITER_FILE_H
+
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <stddef.h>
+
+typedef struct allocator_t allocator_t;
+
+#ifndef ITER_API
+    #define ITER_API
+#endif
+
+#ifndef ITER_INLINE
+    #define ITER_INLINE static inline
+#endif
+
+/** # File iterators
+
+    File iterators map a whole file into memory and return views of its
+    lines or records, pointing straight into the mapping, so no bytes are
+    copied. The mapping is advised for sequential access.
+
+    Views stay valid until the iterator, and every iterator split from it,
+    has been freed with `iter_free`, even once they are exhausted, so views
+    can be collected with `vector_from_iter` and read afterwards. The mapping
+    is only released by `iter_free`, so file iterators always have to be
+    freed. Files must not be truncated while they are mapped.
+
+    File iterators support `iter_split`, so they can be traversed with
+    `iter_parallel_each`. Splitting is `O(1)` for records, while lines are
+    split at the first newline after the middle of the remaining bytes.
+**/
+
+/** typedef struct iter_view_t;
+
+    Item returned by file iterators: `length` bytes starting at `data`.
+    Views are not terminated by a `'\0'`.
+**/
+typedef struct iter_view_t {
+    const char *data;
+    size_t length;
+} iter_view_t;
+
+/** iter(iter_view_t) iter_from_file_lines(
+        iter_t *out,
+        const char *path,
+        allocator_t *allocator
+    );
+
+    Creates an iterator over lines of the file at `path`. Lines are
+    separated by `'\n'`, which isn't included in the views. A final line
+    without a trailing newline is returned as well, so an empty file has no
+    lines. Newlines are searched for 16 bytes at a time with SIMD.
+
+    The shared state of the mapping is allocated with `allocator`, or the
+    default one if `NULL`. Returns `NULL` if the file can't be opened or
+    mapped, in which case `errno` is set, or if out of memory.
+**/
+#define iter_from_file_lines(m_out, m_path, m_allocator) \
+    ((iter(iter_view_t))iter__from_file_lines(            \
+        (m_out), (m_path), (m_allocator)                  \
+    ))
+
+ITER_API iter_t *iter__from_file_lines(
+    iter_t *out, const char *path, allocator_t *allocator
+);
+
+/** iter(iter_view_t) iter_from_file_records(
+        iter_t *out,
+        const char *path,
+        size_t record_size,
+        allocator_t *allocator
+    );
+
+    Creates an iterator over consecutive records of `record_size` bytes of
+    the file at `path`. If the size of the file isn't a multiple of
+    `record_size`, the last view is shorter.
+
+    Like `iter_from_file_lines`, but also returns `NULL` if `record_size`
+    is 0.
+**/
+#define iter_from_file_records(m_out, m_path, m_record_size, m_allocator) \
+    ((iter(iter_view_t))iter__from_file_records(                          \
+        (m_out), (m_path), (m_record_size), (m_allocator)                 \
+    ))
+
+ITER_API iter_t *iter__from_file_records(
+    iter_t *out, const char *path, size_t record_size, allocator_t *allocator
+);
+
+/** ## External sort
+
+    `iter_sort_external` sorts more items than fit into memory. Items are
+    read in runs that fill two thirds of the memory budget, while the rest
+    is used as scratch space for sorting them. Sorted runs are written to
+    a single temporary file, which is unlinked right after being created,
+    and are then merged lazily with `iter_merge`, each of them read back
+    through its own share of the budget with large sequential reads.
+**/
+
+/** iter(T) iter_sort_external(
+        iter_t *out,
+        iter(T) src,
+        iter_compare_fn *cmp,
+        size_t mem_budget,
+        const char *tmpdir,
+        allocator_t *allocator
+    );
+
+    Creates an iterator over the items of `src`, sorted according to `cmp`,
+    using about `mem_budget` bytes of memory. `src` is consumed before this
+    function returns. If it fits into a single run, items are returned
+    straight from memory and no file is created. The sort is stable.
+
+    The temporary file is created in `tmpdir`, or in `$TMPDIR` or `/tmp`
+    if `NULL`. The state is allocated with `allocator`, or the default one
+    if `NULL`, and freed once the iterator is exhausted or by `iter_free`.
+    Returns `NULL` if `mem_budget` can't hold two items, if out of memory,
+    or if the temporary file can't be written, in which case `errno` is
+    set. If reading a run back fails, the iterator returns ITER_EIO.
+**/
+#define iter_sort_external(                                      \
+    m_out, m_src, m_cmp, m_mem_budget, m_tmpdir, m_allocator     \
+)                                                                \
+    ((typeof(m_src))iter__sort_external(                         \
+        (m_out),                                                 \
+        iter_as_base(m_src),                                     \
+        (m_cmp),                                                 \
+        (m_mem_budget),                                          \
+        (m_tmpdir),                                              \
+        (m_allocator),                                           \
+        iter_type_size(m_src)                                    \
+    ))
+
+ITER_API iter_t *iter__sort_external(
+    iter_t *out,
+    iter_t *src,
+    iter_compare_fn *cmp,
+    size_t mem_budget,
+    const char *tmpdir,
+    allocator_t *allocator,
+    size_t size
+);
+
+#endif
@@ -0,0 +1,228 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_GAPVEC_H
+#define LIBITER_GAPVEC_H
+
+#include <iter/error.h>
+#include <iter/generic.h>
+#include <iter/iter.h>
+#include <stddef.h>
+
+typedef struct allocator_t allocator_t;
+
+#ifndef ITER_API
+    #define ITER_API
+#endif
+
+#ifndef ITER_INLINE
+    #define ITER_INLINE static inline
+#endif
+
+/** # gapvec(T) - Gap buffers
+
+    gapvec(T) is a growable array that keeps its unused space, the gap,
+    at the position of the last edit instead of at the end. Inserting or
+    removing items moves the gap to the edit point first, which only moves
+    the items between the old and the new position. Repeated edits around
+    a cursor cost `O(edit)` instead of `O(length)`.
+
+    Items are split into two spans, before and after the gap, but `gapvec_get`
+    and iterators see them as a single contiguous sequence. Pointers to items
+    are invalidated by any insertion or removal.
+**/
+
+#define gapvec(T) generic_container(gapvec_t, size_t, T)
+
+typedef struct gapvec_t {
+    void *items;
+    size_t gap;
+    size_t gap_length;
+    size_t capacity;
+    allocator_t *allocator;
+} gapvec_t;
+
+#define gapvec_type(m_gv) generic_value_type(gapvec_t, m_gv)
+#define gapvec_type_ptr(m_gv) generic_value_ptr(gapvec_t, m_gv)
+#define gapvec_type_size(m_gv) generic_value_size(gapvec_t, m_gv)
+#define gapvec_type_mul(m_gv, m_i)                                    \
+    iter__checked_umulsize(generic_value_size(gapvec_t, m_gv), m_i)
+
+#define gapvec_as_base(m_gv) generic_check_container(gapvec_t, size_t, m_gv)
+#define gapvec_check_type(m_gv, m_item)         \
+    generic_check_value(gapvec_t, m_gv, m_item)
+
+/** gapvec(T) gapvec_create(type T, allocator_t *allocator);
+
+    Creates a new instance of `gapvec(T)`, allocated with `allocator`.
+    Returns `NULL` if out of memory or `sizeof(T) == 0`.
+
+    > If `allocator` is `NULL`, the default one will be used.
+**/
+#define gapvec_create(T, m_allocator) ((gapvec(T))gapvec__create((m_allocator)))
+ITER_API gapvec_t *gapvec__create(allocator_t *allocator);
+
+/** void gapvec_destroy(gapvec(T) gv);
+
+    Frees all resources used by `gv` if it's not `NULL`.
+**/
+#define gapvec_destroy(m_gv) gapvec__destroy(gapvec_as_base(m_gv))
+ITER_API void gapvec__destroy(gapvec_t *gv);
+
+/** size_t gapvec_length(gapvec(T) gv);
+
+    Returns number of items present in `gv` or 0 if `gv` is `NULL`.
+**/
+#define gapvec_length(m_gv)                                         \
+    (gapvec__length(gapvec_as_base(m_gv)) / gapvec_type_size(m_gv))
+
+ITER_INLINE size_t gapvec__length(const gapvec_t *gv) {
+    return gv ? gv->capacity - gv->gap_length : 0;
+}
+
+/** size_t gapvec_cursor(gapvec(T) gv);
+
+    Returns the index at which the gap currently starts,
+    i.e. the index of the last edit.
+**/
+#define gapvec_cursor(m_gv)                                         \
+    (gapvec__cursor(gapvec_as_base(m_gv)) / gapvec_type_size(m_gv))
+
+ITER_INLINE size_t gapvec__cursor(const gapvec_t *gv) {
+    return gv ? gv->gap : 0;
+}
+
+/** T *gapvec_get(gapvec(T) gv, size_t i);
+
+    Returns pointer to the item at index `i` or `NULL` if out of bounds.
+
+    > This pointer is valid until `gv` is edited or destroyed.
+**/
+#define gapvec_get(m_gv, m_i)                                              \
+    ((gapvec_type_ptr(m_gv))                                               \
+         gapvec__get(gapvec_as_base(m_gv), gapvec_type_mul(m_gv, m_i)))
+
+ITER_INLINE void *gapvec__get(const gapvec_t *gv, size_t i) {
+    if (!gv || i >= gv->capacity - gv->gap_length)
+        return NULL;
+
+    if (i >= gv->gap)
+        i += gv->gap_length;
+
+    return &((unsigned char *)gv->items)[i];
+}
+
+/** size_t gapvec_spans(
+        gapvec(T) gv,
+        T **first,
+        size_t *first_len,
+        T **second,
+        size_t *second_len
+    );
+
+    Stores the spans of items before and after the gap in `first` and
+    `second` and their lengths, in items, in `first_len` and `second_len`.
+    Returns the total number of items.
+**/
+#define gapvec_spans(m_gv, m_first, m_first_len, m_second, m_second_len) \
+    gapvec__spans(                                                        \
+        gapvec_as_base(m_gv),                                             \
+        (void **)pf_check_type(gapvec_type_ptr(m_gv) *, m_first),         \
+        (m_first_len),                                                    \
+        (void **)pf_check_type(gapvec_type_ptr(m_gv) *, m_second),        \
+        (m_second_len),                                                   \
+        gapvec_type_size(m_gv)                                            \
+    )
+
+ITER_API size_t gapvec__spans(
+    const gapvec_t *gv,
+    void **first,
+    size_t *first_len,
+    void **second,
+    size_t *second_len,
+    size_t size
+);
+
+/** int gapvec_move_gap(gapvec(T) gv, size_t i);
+
+    Moves the gap so that it starts before the item at index `i`.
+    Possible error codes: ITER_EINVAL.
+**/
+#define gapvec_move_gap(m_gv, m_i)                                         \
+    gapvec__move_gap(gapvec_as_base(m_gv), gapvec_type_mul(m_gv, m_i))
+
+ITER_API int gapvec__move_gap(gapvec_t *gv, size_t i);
+
+/** int gapvec_reserve(gapvec(T) gv, size_t count);
+
+    Reserves space to fit at least `count` more items in `gv`.
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define gapvec_reserve(m_gv, m_count)                  \
+    gapvec__reserve(                                   \
+        gapvec_as_base(m_gv),                          \
+        gapvec_type_mul(m_gv, m_count),                \
+        gapvec_type_size(m_gv)                         \
+    )
+
+ITER_API int gapvec__reserve(gapvec_t *gv, size_t size, size_t stride);
+
+/** int gapvec_insert(gapvec(T) gv, const T *items, size_t i, size_t count);
+
+    Inserts `count` items from `items` starting at index `i`.
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define gapvec_insert(m_gv, m_items, m_i, m_count) \
+    gapvec__insert(                                \
+        gapvec_as_base(m_gv),                      \
+        gapvec_check_type(m_gv, m_items),          \
+        gapvec_type_mul(m_gv, m_i),                \
+        gapvec_type_mul(m_gv, m_count),            \
+        gapvec_type_size(m_gv)                     \
+    )
+
+ITER_API int gapvec__insert(
+    gapvec_t *gv, const void *items, size_t i, size_t size, size_t stride
+);
+
+/** int gapvec_remove(gapvec(T) gv, size_t i, size_t count);
+
+    Removes `count` items starting at index `i`.
+    Possible error codes: ITER_EINVAL.
+**/
+#define gapvec_remove(m_gv, m_i, m_count) \
+    gapvec__remove(                       \
+        gapvec_as_base(m_gv),             \
+        gapvec_type_mul(m_gv, m_i),       \
+        gapvec_type_mul(m_gv, m_count)    \
+    )
+
+ITER_API int gapvec__remove(gapvec_t *gv, size_t i, size_t size);
+
+/** T *gapvec_flatten(gapvec(T) gv);
+
+    Moves the gap to the end of `gv` and returns pointer to the first item,
+    so that all items can be accessed as a regular array.
+    Returns `NULL` if `gv` is empty.
+**/
+#define gapvec_flatten(m_gv)                                        \
+    ((gapvec_type_ptr(m_gv))gapvec__flatten(gapvec_as_base(m_gv)))
+
+ITER_API void *gapvec__flatten(gapvec_t *gv);
+
+/** iter(T) gapvec_iter(gapvec(T) gv, iter_t *out);
+
+    Initializes `out` as an iterator traversing items present in `gv`.
+
+    > Editing the gap buffer will invalidate the returned iterator.
+**/
+#define gapvec_iter(m_gv, m_out)                                             \
+    ((iter(gapvec_type(m_gv)))gapvec__iter(gapvec_as_base(m_gv), (m_out)))
+
+ITER_API iter_t *gapvec__iter(const gapvec_t *gv, iter_t *out);
+
+#endif
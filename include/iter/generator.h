@@ -0,0 +1,148 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_GENERATOR_H
+#define LIBITER_GENERATOR_H
+
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef ITER_API
+    #define ITER_API
+#endif
+
+#ifndef ITER_INLINE
+    #define ITER_INLINE static inline
+#endif
+
+/** # Generators
+
+    Generators are iterators written as producer functions, which `yield`
+    their items one at a time. Every call of `iter_next` resumes the
+    function right after the `ITER_YIELD` it returned from, so it reads like
+    a plain loop, instead of a state machine written by hand.
+
+    ```c
+    struct range {
+        int i, end;
+    };
+
+    static int range_gen(iter_gen_t *gen, void *state, void *out) {
+        struct range *r = state;
+
+        ITER_GEN_BEGIN(gen);
+        for (; r->i < r->end; r->i++)
+            ITER_YIELD(gen, out, r->i);
+        ITER_GEN_END(gen);
+    }
+
+    struct range r = { 0, 10 };
+    iter_t storage;
+    iter(int) it = iter_generator(&storage, int, range_gen, &r);
+    ```
+
+    Generators are stackless: the resume point is a `switch` over line
+    numbers, in the style of protothreads, so resuming one costs a call and
+    a jump, and no stack has to be allocated or switched to. As a result:
+
+    - Local variables of the function are not preserved across yields.
+      Everything that is, like `r->i` above, has to live in `state`.
+    - `ITER_YIELD` can't be used inside a `switch` statement of the
+      function, and there can't be more than one `ITER_YIELD` per line.
+**/
+
+/** typedef struct iter_gen_t;
+
+    Resume point of a generator and the size of its items, stored inside its
+    `iter_t`.
+**/
+typedef struct iter_gen_t {
+    int line;
+    size_t size;
+} iter_gen_t;
+
+/** typedef int(iter_gen_fn)(iter_gen_t *gen, void *state, void *out);
+
+    Producer function of a generator. The body has to be enclosed by
+    `ITER_GEN_BEGIN` and `ITER_GEN_END`, and items are returned with
+    `ITER_YIELD`. `out` is `NULL` while items are skipped. Returning an
+    error code other than with `ITER_YIELD` ends the generator.
+**/
+typedef int(iter_gen_fn)(iter_gen_t *gen, void *state, void *out);
+
+/** ITER_GEN_BEGIN(iter_gen_t *gen);
+
+    Starts the body of a generator, resuming it at its last yield.
+**/
+#define ITER_GEN_BEGIN(m_gen) \
+    switch ((m_gen)->line) {  \
+    case 0:
+
+/** ITER_YIELD(iter_gen_t *gen, void *out, T value);
+
+    Stores `value` into `out` and returns it from the generator. The next
+    call resumes right after this statement. `value` has to be as large as
+    the items of the iterator, so for example a `long` expression yielded
+    from an `iter(int)` generator has to be cast. Otherwise, nothing is
+    stored and the generator ends with ITER_EINVAL.
+**/
+#define ITER_YIELD(m_gen, m_out, m_value)                       \
+    do {                                                        \
+        typeof(m_value) iter__yield = (m_value);                \
+        if (sizeof(iter__yield) != (m_gen)->size) {             \
+            (m_gen)->line = ITER__GEN_DONE;                     \
+            return ITER_EINVAL;                                 \
+        }                                                       \
+        (m_gen)->line = __LINE__;                               \
+        if (m_out)                                              \
+            memcpy((m_out), &iter__yield, sizeof(iter__yield)); \
+        return ITER_OK;                                         \
+    case __LINE__:;                                             \
+    } while (0)
+
+/** ITER_GEN_RETURN(iter_gen_t *gen);
+
+    Ends the generator, so this and every later call return ITER_ENODATA.
+**/
+#define ITER_GEN_RETURN(m_gen)            \
+    do {                                  \
+        (m_gen)->line = ITER__GEN_DONE;   \
+        return ITER_ENODATA;              \
+    } while (0)
+
+/** ITER_GEN_END(iter_gen_t *gen);
+
+    Ends the body of a generator, which ends once it gets here.
+**/
+#define ITER_GEN_END(m_gen) \
+    }                       \
+    ITER_GEN_RETURN(m_gen)
+
+#define ITER__GEN_DONE (-1)
+
+/** iter(T) iter_generator(
+        iter_t *out,
+        type T,
+        iter_gen_fn *fn,
+        void *state
+    );
+
+    Creates an iterator over items of type `T`, yielded by `fn` called with
+    `state`. The generator is stored in `out`, so nothing is allocated,
+    while `state` is owned by the caller and has to outlive the iterator.
+    Returns `NULL` if `fn` is `NULL`.
+**/
+#define iter_generator(m_out, T, m_fn, m_state)                      \
+    ((iter(T))iter__generator((m_out), (m_fn), (m_state), sizeof(T)))
+
+ITER_API iter_t *iter__generator(
+    iter_t *out, iter_gen_fn *fn, void *state, size_t size
+);
+
+#endif
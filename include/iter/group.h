@@ -0,0 +1,172 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_GROUP_H
+#define LIBITER_GROUP_H
+
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <stddef.h>
+
+typedef struct allocator_t allocator_t;
+
+#ifndef ITER_API
+    #define ITER_API
+#endif
+
+#ifndef ITER_INLINE
+    #define ITER_INLINE static inline
+#endif
+
+/** # Grouping
+
+    Grouping iterators aggregate the items of `src` by their keys and return
+    a pair for every group, declared with `iter_pair(K, A)`, holding the key
+    as `first` and the aggregate as `second`. Keys are written by `key` into
+    zeroed buffers and compared bytewise. The aggregate of a group is set up
+    by `init` when its first item is found, and every item of the group is
+    then passed to `accumulate`.
+
+    ```c
+    typedef iter_pair(int, long) customer_total_t;
+
+    static void total_init(void *acc, const void *key, void *user) {
+        *(long *)acc = 0;
+    }
+
+    static void total_add(void *acc, const void *item, void *user) {
+        *(long *)acc += ((const struct order *)item)->amount;
+    }
+
+    iter_t storage;
+    iter(customer_total_t) it = iter_group_aggregate(
+        &storage, orders, customer_total_t, order_customer_id,
+        total_init, total_add, NULL, 0, NULL
+    );
+    ```
+
+    `src` is not owned by the iterator; it must outlive it and is not freed
+    by `iter_free`. The state is allocated with `allocator`, or the default
+    one if `NULL`, and freed once the iterator is exhausted or by
+    `iter_free`. If reading `src` fails with anything but ITER_ENODATA, the
+    iterator returns that error, as well as ITER_ENOMEM if out of memory.
+
+    ```c
+    typedef void(iter_init_fn)(void *acc, const void *key, void *user);
+    typedef void(iter_accumulate_fn)(void *acc, const void *item, void *user);
+    ```
+**/
+
+typedef void(iter_init_fn)(void *acc, const void *key, void *user);
+typedef void(iter_accumulate_fn)(void *acc, const void *item, void *user);
+
+/** iter(P) iter_group_aggregate(
+        iter_t *out,
+        iter(T) src,
+        type P,
+        iter_key_fn *key,
+        iter_init_fn *init,
+        iter_accumulate_fn *accumulate,
+        void *user,
+        size_t max_groups,
+        allocator_t *allocator
+    );
+
+    Creates an iterator aggregating the items of `src` into a hash map,
+    looking each key up once with `hashmap_upsert`. Groups are returned in
+    no particular order, once `src` is exhausted.
+
+    If `max_groups` is not 0, the map is flushed early whenever an item
+    would start a new group past `max_groups`: groups aggregated so far are
+    returned, and aggregation continues with an empty map. A key may then
+    be returned more than once, with partial aggregates that have to be
+    combined by the caller, but memory stays bounded by `max_groups`.
+    Returns `NULL` if out of memory.
+**/
+#define iter_group_aggregate(                                          \
+    m_out, m_src, P, m_key, m_init, m_accumulate, m_user, m_max_groups, \
+    m_allocator                                                         \
+)                                                                       \
+    ((iter(P))iter__group_aggregate(                                    \
+        (m_out),                                                        \
+        iter_as_base(m_src),                                            \
+        (m_key),                                                        \
+        (m_init),                                                       \
+        (m_accumulate),                                                 \
+        (m_user),                                                       \
+        (m_max_groups),                                                 \
+        (m_allocator),                                                  \
+        iter_type_size(m_src),                                          \
+        sizeof(((P *)0)->first),                                        \
+        offsetof(P, second),                                            \
+        sizeof(P)                                                       \
+    ))
+
+ITER_API iter_t *iter__group_aggregate(
+    iter_t *out,
+    iter_t *src,
+    iter_key_fn *key,
+    iter_init_fn *init,
+    iter_accumulate_fn *accumulate,
+    void *user,
+    size_t max_groups,
+    allocator_t *allocator,
+    size_t ssize,
+    size_t ksize,
+    size_t aoffset,
+    size_t psize
+);
+
+/** iter(P) iter_group_aggregate_sorted(
+        iter_t *out,
+        iter(T) src,
+        type P,
+        iter_key_fn *key,
+        iter_init_fn *init,
+        iter_accumulate_fn *accumulate,
+        void *user,
+        allocator_t *allocator
+    );
+
+    Like `iter_group_aggregate`, but for `src` with equal keys next to each
+    other, such as sorted inputs. No hash map is needed, since only the
+    current group is kept, and each group is returned as soon as the first
+    item of the next one is read, in the order of `src`.
+    Returns `NULL` if out of memory.
+**/
+#define iter_group_aggregate_sorted(                                    \
+    m_out, m_src, P, m_key, m_init, m_accumulate, m_user, m_allocator   \
+)                                                                       \
+    ((iter(P))iter__group_aggregate_sorted(                             \
+        (m_out),                                                        \
+        iter_as_base(m_src),                                            \
+        (m_key),                                                        \
+        (m_init),                                                       \
+        (m_accumulate),                                                 \
+        (m_user),                                                       \
+        (m_allocator),                                                  \
+        iter_type_size(m_src),                                          \
+        sizeof(((P *)0)->first),                                        \
+        offsetof(P, second),                                            \
+        sizeof(P)                                                       \
+    ))
+
+ITER_API iter_t *iter__group_aggregate_sorted(
+    iter_t *out,
+    iter_t *src,
+    iter_key_fn *key,
+    iter_init_fn *init,
+    iter_accumulate_fn *accumulate,
+    void *user,
+    allocator_t *allocator,
+    size_t ssize,
+    size_t ksize,
+    size_t aoffset,
+    size_t psize
+);
+
+#endif
@@ -268,6 +268,24 @@ ITER_API int hashmap__insert(
     hashmap_t *map, const void *key, const void *value
 );
 
+/** V *hashmap_upsert(hashmap(K, V) map, const K *key, int *inserted);
+
+    Returns the value associated with `key`, inserting `key` with an
+    uninitialized value if not present, with a single probe of `map`.
+    If `inserted` is not `NULL`, it's set to 1 if `key` was inserted and
+    to 0 otherwise. Returns `NULL` if out of memory.
+**/
+#define hashmap_upsert(m_map, m_key, m_inserted)                      \
+    ((hashmap_value_ptr(m_map))hashmap__upsert(                       \
+        hashmap_as_base(m_map),                                       \
+        hashmap_check_key(m_map, m_key),                              \
+        (m_inserted)                                                  \
+    ))
+
+ITER_API void *hashmap__upsert(
+    hashmap_t *map, const void *key, int *inserted
+);
+
 /** int hashmap_remove(hashmap(K, V) map, const K *key);
 
     Removes the key-value pair matched by `key`, if found.
@@ -11,6 +11,9 @@
 #include <iter/error.h>
 #include <iter/generic.h>
 #include <stddef.h>
+#include <stdint.h>
+
+typedef struct allocator_t allocator_t;
 
 #ifndef ITER_API
     #define ITER_API
@@ -44,21 +47,112 @@ typedef struct iter_t iter_t;
 **/
 typedef int(iter_fn)(iter_t *iter, void *out, size_t size, size_t skip);
 
+/** typedef size_t(
+        iter_next_n_fn
+    )(iter_t *self, void *out, size_t max, size_t size);
+
+    Optional batched version of `iter_fn`. The function should store up to
+    `max` items, each `size` bytes in size, into the array `out` and return
+    the number of stored items. Returning less than `max` means that no more
+    items are available at the time of calling.
+**/
+typedef size_t(iter_next_n_fn)(iter_t *it, void *out, size_t max, size_t size);
+
+/** typedef int(iter_next_span_fn)(
+        iter_t *self,
+        const void **items,
+        size_t *count,
+        uint64_t *mask,
+        size_t size
+    );
+
+    Optional operation that returns the next run of items stored in the
+    iterated container. See `iter_next_span` for its contract.
+**/
+typedef int(iter_next_span_fn)(
+    iter_t *it, const void **items, size_t *count, uint64_t *mask, size_t size
+);
+
+/** typedef int(iter_split_fn)(iter_t *self, iter_t *out, size_t size);
+
+    Optional operation that moves the back half of the remaining items of
+    `self` into a new iterator `out`, so both can be traversed independently.
+    Should return ITER_ENODATA if too few items remain to be divided.
+**/
+typedef int(iter_split_fn)(iter_t *it, iter_t *out, size_t size);
+
+/** typedef void(iter_size_hint_fn)(
+        iter_t *self,
+        size_t *lower,
+        size_t *upper,
+        size_t size
+    );
+
+    Optional operation that stores bounds on the number of remaining items
+    into `lower` and `upper`. See `iter_size_hint` for its contract.
+**/
+typedef void(iter_size_hint_fn)(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+);
+
+/** struct iter_ops;
+
+    Table of optional operations, which iterators can implement in addition
+    to their `call`. Any member can be `NULL`, in which case the interface
+    falls back to `call`, if possible.
+
+    Custom iterators might leave `ops` uninitialized, so it's only used once
+    `call(it, NULL, 0, 0)` returns ITER_HAS_OPS. Skipping no items is a no-op
+    for any other iterator. Iterators that set `ops` have to answer that
+    request first:
+
+    ```c
+    static int my_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+        if (ITER_IS_OPS_QUERY(out, size, skip))
+            return ITER_HAS_OPS;
+        ...
+    }
+    ```
+**/
+struct iter_ops {
+    iter_next_n_fn *next_n;
+    iter_next_span_fn *next_span;
+    iter_split_fn *split;
+    iter_size_hint_fn *size_hint;
+};
+
+enum {
+    ITER_HAS_OPS = 0x6F7073,
+};
+
+#define ITER_IS_OPS_QUERY(m_out, m_size, m_skip) \
+    (!(m_out) && (m_size) == 0 && (m_skip) == 0)
+
 /** struct iter_t;
 
     This structure is used as an interface for traversing items of containers.
     Every member other than `call` is not used by the interface; they are
     reserved for use by the iterator's callback and should be treated as
-    private variables.
+    private variables. `ops` is only read from iterators that answer the
+    request described in `struct iter_ops`, so custom iterators only have to
+    set `call`.
 **/
 struct iter_t {
     iter_fn *call;
+    const struct iter_ops *ops;
     union {
-        char _size[sizeof(void *) * 3];
+        char _size[sizeof(void *) * 5];
         void *_alignment;
     } buffer;
 };
 
+/* Checks that the state of an iterator fits into the buffer of `iter_t`. */
+#define ITER__ASSERT_FITS(T)                                \
+    _Static_assert(                                         \
+        sizeof(T) <= sizeof(((iter_t *)0)->buffer),         \
+        #T " doesn't fit into the buffer of iter_t"         \
+    )
+
 #define iter_type(m_iter) generic_value_type(iter_t, m_iter)
 #define iter_type_ptr(m_iter) generic_value_ptr(iter_t, m_iter)
 #define iter_type_size(m_iter) generic_value_size(iter_t, m_iter)
@@ -80,6 +174,12 @@ ITER_INLINE int iter__call(iter_t *it, void *out, size_t size, size_t skip) {
     return it && it->call ? it->call(it, out, size, skip) : ITER_EINVAL;
 }
 
+ITER_INLINE const struct iter_ops *iter__ops(iter_t *it) {
+    if (!it || !it->call || it->call(it, NULL, 0, 0) != ITER_HAS_OPS)
+        return NULL;
+    return it->ops;
+}
+
 /** int iter_next(iter(T) it, T *out)
 
     Advances the iterator and puts the next value in `out`, if not `NULL`.
@@ -125,10 +225,120 @@ ITER_INLINE int iter__call(iter_t *it, void *out, size_t size, size_t skip) {
         iter_as_base(m_iter), iter_as_base(m_iter), iter_type_size(m_iter), 0 \
     )
 
+/** size_t iter_next_n(iter(T) it, T *out, size_t max);
+
+    Advances the iterator up to `max` times, storing the items into the array
+    `out`, and returns the number of stored items. Iterators of arrays,
+    vectors, pools and hash maps copy their items in bulk, without a call
+    per item. Other iterators fall back to `iter_next`.
+**/
+#define iter_next_n(m_iter, m_out, m_max) \
+    iter__next_n(                         \
+        iter_as_base(m_iter),             \
+        iter_check_type(m_iter, m_out),   \
+        (m_max),                          \
+        iter_type_size(m_iter)            \
+    )
+
+ITER_API size_t iter__next_n(iter_t *it, void *out, size_t max, size_t size);
+
+/** int iter_next_span(
+        iter(T) it,
+        const T **items,
+        size_t *count,
+        uint64_t *mask
+    );
+
+    Advances the iterator past the next run of items, that sit next to each
+    other in the iterated container, without copying them. A pointer to the
+    first item is stored in `items` and the length of the run in `count`.
+    The pointer is valid until the container is modified.
+
+    If `mask` is `NULL`, every item of the run is present. Otherwise, runs of
+    pools and hash maps can contain free slots: the run is at most 64 slots
+    long and only slots with their bit set in `*mask` hold items. Runs longer
+    than 64 items are dense and always have every bit of `*mask` set.
+
+    ```c
+    const int *items;
+    size_t count;
+    uint64_t mask;
+
+    while (!iter_next_span(it, &items, &count, &mask)) {
+        for (size_t i = 0; i < count; i++)
+            if (i >= 64 || mask >> i & 1)
+                sum += items[i];
+    }
+    ```
+
+    Supported by iterators of arrays, vectors, gap buffers, pools and hash
+    maps, but not by their `_ref` variants. Other iterators return
+    ITER_ENOSYS, in which case `iter_next_n` should be used instead.
+
+    Possible error codes: ITER_EINVAL, ITER_ENODATA, ITER_ENOSYS.
+**/
+#define iter_next_span(m_iter, m_items, m_count, m_mask)                   \
+    iter__next_span(                                                       \
+        iter_as_base(m_iter),                                              \
+        (const void **)pf_check_type(const iter_type(m_iter) **, m_items), \
+        (m_count),                                                         \
+        (m_mask),                                                          \
+        iter_type_size(m_iter)                                             \
+    )
+
+ITER_API int iter__next_span(
+    iter_t *it, const void **items, size_t *count, uint64_t *mask, size_t size
+);
+
+/** iter(T) iter_split(iter(T) it, iter_t *out);
+
+    Divides the remaining items of `it` in two: `it` keeps the front half,
+    while the back half is moved to a new iterator, stored in `out`.
+    Traversing `it` and then the returned iterator yields the same items,
+    in the same order, as traversing `it` alone would have.
+
+    Arrays and vectors are split by index, pools by buckets and hash maps
+    by ranges of metadata groups, so halves are only roughly equal for the
+    latter two. Returns `NULL` if `it` doesn't support splitting or if too
+    few items remain to be divided.
+
+    Iterators holding resources share them between the halves, so both have
+    to be exhausted or freed with `iter_free`.
+**/
+#define iter_split(m_iter, m_out)                                         \
+    ((typeof(m_iter))                                                     \
+         iter__split(iter_as_base(m_iter), (m_out), iter_type_size(m_iter)))
+
+ITER_API iter_t *iter__split(iter_t *it, iter_t *out, size_t size);
+
+/** void iter_size_hint(iter(T) it, size_t *lower, size_t *upper);
+
+    Stores bounds on the number of items remaining in `it`: at least `lower`
+    and at most `upper` items will be returned, unless the container is
+    modified. `upper` is `SIZE_MAX` if the bound is unknown. Either pointer
+    can be `NULL`.
+
+    Iterators of arrays, vectors, gap buffers, pools and hash maps report
+    exact counts, and adapters derive their bounds from their sources.
+    Other iterators report `0` and `SIZE_MAX`.
+**/
+#define iter_size_hint(m_iter, m_lower, m_upper) \
+    iter__size_hint(                             \
+        iter_as_base(m_iter),                    \
+        (m_lower),                               \
+        (m_upper),                               \
+        iter_type_size(m_iter)                   \
+    )
+
+ITER_API void iter__size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+);
+
 /** size_t iter_to_array(iter(T) it, T *out, size_t length);
 
     Traverser the iterator `it` and inserts the items into `out`, until
     `length` items have been collected or the iterator has been exhausted.
+    Equivalent to `iter_next_n`.
 **/
 #define iter_to_array(m_iter, m_out, m_length) \
     iter__to_array(                            \
@@ -172,4 +382,324 @@ ITER_API iter_t *iter__ref_from_array(
     iter_t *out, const void *items, size_t length, size_t stride
 );
 
+/** iter(T) iter_merge(
+        iter_t *out,
+        iter(T) *inputs,
+        size_t k,
+        iter_compare_fn *cmp,
+        allocator_t *allocator
+    );
+
+    Creates an iterator that lazily merges `k` iterators from `inputs`,
+    each of them sorted according to `cmp`, into a single sorted sequence.
+    Items are selected with a loser tree, making each step `O(log k)`.
+    Equal items are returned in the order of their inputs.
+
+    The state of the iterator is allocated with `allocator` and freed once
+    it's exhausted or by `iter_free`. The input iterators are not freed and
+    must outlive the returned iterator. Returns `NULL` if out of memory.
+
+    ```c
+    typedef int(iter_compare_fn)(const void *lhs, const void *rhs, size_t s);
+    ```
+**/
+#define iter_merge(m_out, m_inputs, m_k, m_cmp, m_allocator) \
+    ((iter(iter_type(*(m_inputs))))iter__merge(              \
+        (m_out),                                             \
+        (iter_t **)(m_inputs),                               \
+        (m_k),                                               \
+        iter_type_size(*(m_inputs)),                         \
+        (m_cmp),                                             \
+        (m_allocator)                                        \
+    ))
+
+typedef int(iter_compare_fn)(const void *lhs, const void *rhs, size_t size);
+
+/* Writes the key of `item` into `key`, used by joins and grouping. */
+typedef void(iter_key_fn)(void *key, const void *item, void *user);
+
+ITER_API iter_t *iter__merge(
+    iter_t *out,
+    iter_t **inputs,
+    size_t k,
+    size_t size,
+    iter_compare_fn *cmp,
+    allocator_t *allocator
+);
+
+/** ## Adapters
+
+    Adapters are iterators that lazily transform the items of another
+    iterator, their source, one item at a time. Their state is stored in
+    the `iter_t` passed as `out`, so they don't allocate and don't need to
+    be freed. Adapters can be nested to build single-pass pipelines without
+    intermediate containers:
+
+    ```c
+    iter_t a, b, c;
+    iter(int) it = vector_iter(numbers, &a);
+    iter(int) odd = iter_filter(&b, it, is_odd, NULL);
+    iter(double) halves = iter_map(&c, odd, double, halve, NULL);
+    ```
+
+    Sources are not owned by their adapters; they must outlive them and
+    are not freed by `iter_free`. Skipping with `iter_nth` or `iter_advance`
+    is forwarded to the source whenever the adapter keeps a 1:1 mapping of
+    items, so it's as fast as skipping the source itself.
+**/
+
+/** iter(D) iter_map(
+        iter_t *out,
+        iter(S) src,
+        type D,
+        iter_map_fn *map,
+        void *user
+    );
+
+    Creates an iterator, that maps items of `src` to items of type `D` by
+    calling `map`. If `map` returns a non-zero value, iteration returns
+    ITER_EINTR.
+
+    ```c
+    typedef int(iter_map_fn)(void *dst, void *src, void *user);
+    ```
+**/
+#define iter_map(m_out, m_src, D, m_map, m_user) \
+    ((iter(D))iter__map(                         \
+        (m_out),                                 \
+        iter_as_base(m_src),                     \
+        (m_map),                                 \
+        (m_user),                                \
+        iter_type_size(m_src)                    \
+    ))
+
+typedef int(iter_map_fn)(void *dst, void *src, void *user);
+
+ITER_API iter_t *iter__map(
+    iter_t *out, iter_t *src, iter_map_fn *map, void *user, size_t ssize
+);
+
+/** iter(T) iter_filter(
+        iter_t *out,
+        iter(T) src,
+        iter_filter_fn *filter,
+        void *user
+    );
+
+    Creates an iterator over the items of `src` for which `filter` returns a
+    non-zero value. Skipping items calls `filter` for every skipped item.
+
+    ```c
+    typedef int(iter_filter_fn)(const void *item, void *user);
+    ```
+**/
+#define iter_filter(m_out, m_src, m_filter, m_user)        \
+    ((typeof(m_src))iter__filter(                          \
+        (m_out), iter_as_base(m_src), (m_filter), (m_user) \
+    ))
+
+typedef int(iter_filter_fn)(const void *item, void *user);
+
+ITER_API iter_t *iter__filter(
+    iter_t *out, iter_t *src, iter_filter_fn *filter, void *user
+);
+
+/** iter(T) iter_take(iter_t *out, iter(T) src, size_t count);
+
+    Creates an iterator over the first `count` items of `src`.
+**/
+#define iter_take(m_out, m_src, m_count) \
+    ((typeof(m_src))iter__take((m_out), iter_as_base(m_src), (m_count)))
+
+ITER_API iter_t *iter__take(iter_t *out, iter_t *src, size_t count);
+
+/** iter(T) iter_skip(iter_t *out, iter(T) src, size_t count);
+
+    Creates an iterator over the items of `src` after the first `count`.
+    The items are skipped lazily, together with the first read.
+**/
+#define iter_skip(m_out, m_src, m_count) \
+    ((typeof(m_src))iter__skip((m_out), iter_as_base(m_src), (m_count)))
+
+ITER_API iter_t *iter__skip(iter_t *out, iter_t *src, size_t count);
+
+/** iter(T) iter_chain(iter_t *out, iter(T) first, iter(T) second);
+
+    Creates an iterator over the items of `first`, followed by the items
+    of `second`. Items skipped within `first` are read one by one, since
+    its length is not known in advance.
+**/
+#define iter_chain(m_out, m_first, m_second)                   \
+    ((typeof(m_first))iter__chain(                             \
+        (m_out),                                               \
+        iter_as_base(m_first),                                 \
+        iter_as_base(pf_check_type(typeof(m_first), m_second)) \
+    ))
+
+ITER_API iter_t *iter__chain(iter_t *out, iter_t *first, iter_t *second);
+
+/** type iter_pair(type A, type B);
+
+    Declares a structure with members `A first` and `B second`,
+    used as the item type of `iter_zip`.
+
+    ```c
+    typedef iter_pair(int, double) int_double_t;
+    ```
+**/
+#define iter_pair(A, B) \
+    struct {            \
+        A first;        \
+        B second;       \
+    }
+
+/** iter(P) iter_zip(iter_t *out, iter(A) a, iter(B) b, type P);
+
+    Creates an iterator over pairs of items of `a` and `b`, which stops once
+    either of them is exhausted. `P` must be a type declared with
+    `iter_pair(A, B)`.
+**/
+#define iter_zip(m_out, m_a, m_b, P) \
+    ((iter(P))iter__zip(             \
+        (m_out),                     \
+        iter_as_base(m_a),           \
+        iter_as_base(m_b),           \
+        iter_type_size(m_a),         \
+        offsetof(P, second),         \
+        iter_type_size(m_b)          \
+    ))
+
+ITER_API iter_t *iter__zip(
+    iter_t *out,
+    iter_t *a,
+    iter_t *b,
+    size_t asize,
+    size_t boffset,
+    size_t bsize
+);
+
+/** type iter_indexed(type T);
+
+    Declares a structure with members `size_t index` and `T value`,
+    used as the item type of `iter_enumerate`.
+**/
+#define iter_indexed(T) \
+    struct {            \
+        size_t index;   \
+        T value;        \
+    }
+
+/** iter(I) iter_enumerate(iter_t *out, iter(T) src, type I);
+
+    Creates an iterator over the items of `src` along with their indexes,
+    starting from 0. `I` must be a type declared with `iter_indexed(T)`.
+**/
+#define iter_enumerate(m_out, m_src, I) \
+    ((iter(I))iter__enumerate(          \
+        (m_out),                        \
+        iter_as_base(m_src),            \
+        offsetof(I, value),             \
+        iter_type_size(m_src)           \
+    ))
+
+ITER_API iter_t *iter__enumerate(
+    iter_t *out, iter_t *src, size_t voffset, size_t ssize
+);
+
+/** ## Chunks and windows
+
+    `iter_chunks` and `iter_windows` group consecutive items of a source
+    into spans, declared with `iter_span(T)`. If the remaining items of the
+    source sit in a single run of its container, like those of arrays and
+    vectors, spans point straight into the container and no item is copied.
+    Otherwise, items are read in batches into an internal buffer, and each
+    span points into it until the next item is requested.
+
+    ```c
+    typedef iter_span(float) float_span_t;
+
+    iter_t a, b;
+    iter(float_span_t) it = iter_windows(
+        &b, vector_iter(samples, &a), float_span_t, 256, 128, NULL
+    );
+    ```
+
+    The state is allocated with `allocator`, or the default one if `NULL`,
+    and freed once the iterator is exhausted or by `iter_free`. Sources are
+    not owned by these iterators; they must outlive them and are not freed.
+**/
+
+/** type iter_span(type T);
+
+    Declares a structure with members `const T *items` and `size_t length`,
+    used as the item type of `iter_chunks` and `iter_windows`.
+**/
+#define iter_span(T)    \
+    struct {            \
+        const T *items; \
+        size_t length;  \
+    }
+
+/** iter(S) iter_chunks(
+        iter_t *out,
+        iter(T) src,
+        type S,
+        size_t n,
+        allocator_t *allocator
+    );
+
+    Creates an iterator over spans of `n` consecutive items of `src`,
+    which don't overlap. The last span is shorter if the number of items
+    isn't a multiple of `n`. `S` must be a type declared with
+    `iter_span(T)`. Returns `NULL` if `n` is 0 or if out of memory.
+**/
+#define iter_chunks(m_out, m_src, S, m_n, m_allocator) \
+    ((iter(S))iter__chunks(                            \
+        (m_out),                                       \
+        iter_as_base(m_src),                           \
+        (m_n),                                         \
+        (m_allocator),                                 \
+        iter_type_size(m_src)                          \
+    ))
+
+ITER_API iter_t *iter__chunks(
+    iter_t *out, iter_t *src, size_t n, allocator_t *allocator, size_t size
+);
+
+/** iter(S) iter_windows(
+        iter_t *out,
+        iter(T) src,
+        type S,
+        size_t n,
+        size_t step,
+        allocator_t *allocator
+    );
+
+    Creates an iterator over spans of `n` consecutive items of `src`,
+    starting every `step` items, so windows overlap if `step` is smaller
+    than `n`, and items between them are skipped if it's larger. Only whole
+    windows are returned. The buffer holds `2 * n` items, and the overlap
+    of buffered windows is moved to its front only once `step` more items
+    no longer fit behind them.
+    Returns `NULL` if `n` or `step` is 0 or if out of memory.
+**/
+#define iter_windows(m_out, m_src, S, m_n, m_step, m_allocator) \
+    ((iter(S))iter__windows(                                    \
+        (m_out),                                                \
+        iter_as_base(m_src),                                    \
+        (m_n),                                                  \
+        (m_step),                                               \
+        (m_allocator),                                          \
+        iter_type_size(m_src)                                   \
+    ))
+
+ITER_API iter_t *iter__windows(
+    iter_t *out,
+    iter_t *src,
+    size_t n,
+    size_t step,
+    allocator_t *allocator,
+    size_t size
+);
+
 #endif
@@ -0,0 +1,157 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_JOIN_H
+#define LIBITER_JOIN_H
+
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <stddef.h>
+
+typedef struct allocator_t allocator_t;
+
+#ifndef ITER_API
+    #define ITER_API
+#endif
+
+#ifndef ITER_INLINE
+    #define ITER_INLINE static inline
+#endif
+
+/** # Joins
+
+    Joins return a pair for every item of `left` and every item of `right`
+    with equal keys. Pairs are declared with `iter_pair(A, B)`, with the
+    item of `left` as `first` and the item of `right` as `second`.
+
+    ```c
+    typedef iter_pair(struct order, struct customer) order_customer_t;
+
+    iter_t storage;
+    iter(order_customer_t) it = iter_hash_join(
+        &storage, orders, customers, order_customer_t, int,
+        order_customer_id, customer_id, NULL, NULL
+    );
+    ```
+
+    The inputs are not owned by joins; they must outlive them and are not
+    freed by `iter_free`. The state of a join is allocated with `allocator`,
+    or the default one if `NULL`, and freed once the join is exhausted or
+    by `iter_free`. If reading an input fails with anything but
+    ITER_ENODATA, the join returns that error.
+**/
+
+/** iter(P) iter_merge_join(
+        iter_t *out,
+        iter(A) left,
+        iter(B) right,
+        type P,
+        iter_join_compare_fn *cmp,
+        void *user,
+        allocator_t *allocator
+    );
+
+    Creates an iterator joining `left` and `right`, both sorted by their
+    keys, in a single pass. `cmp` compares the keys of an item of `left`
+    and an item of `right`. Only the items of `right` sharing the current
+    key are buffered, to pair them with every item of `left` with that key.
+    Pairs are returned in the order of `left`, then `right`.
+    Returns `NULL` if out of memory.
+
+    ```c
+    typedef int(iter_join_compare_fn)(
+        const void *left, const void *right, void *user
+    );
+    ```
+**/
+#define iter_merge_join(m_out, m_left, m_right, P, m_cmp, m_user, m_allocator) \
+    ((iter(P))iter__merge_join(                                               \
+        (m_out),                                                              \
+        iter_as_base(m_left),                                                 \
+        iter_as_base(m_right),                                                \
+        (m_cmp),                                                              \
+        (m_user),                                                             \
+        (m_allocator),                                                        \
+        iter_type_size(m_left),                                               \
+        offsetof(P, second),                                                  \
+        iter_type_size(m_right)                                               \
+    ))
+
+typedef int(iter_join_compare_fn)(
+    const void *left, const void *right, void *user
+);
+
+ITER_API iter_t *iter__merge_join(
+    iter_t *out,
+    iter_t *left,
+    iter_t *right,
+    iter_join_compare_fn *cmp,
+    void *user,
+    allocator_t *allocator,
+    size_t asize,
+    size_t boffset,
+    size_t bsize
+);
+
+/** iter(P) iter_hash_join(
+        iter_t *out,
+        iter(A) left,
+        iter(B) right,
+        type P,
+        type K,
+        iter_key_fn *left_key,
+        iter_key_fn *right_key,
+        void *user,
+        allocator_t *allocator
+    );
+
+    Creates an iterator joining `left` and `right` by keys of type `K`,
+    which are written by `left_key` and `right_key` into zeroed buffers
+    and compared bytewise. The smaller side, according to the upper bounds
+    of `iter_size_hint`, is read into a hash map before this function
+    returns, which is `left` if unknown. The other side is then streamed,
+    and each of its items is paired with the matching items of the smaller
+    side, in their order. Returns `NULL` if out of memory or if reading
+    the smaller side fails.
+
+    ```c
+    typedef void(iter_key_fn)(void *key, const void *item, void *user);
+    ```
+**/
+#define iter_hash_join(                                                 \
+    m_out, m_left, m_right, P, K, m_left_key, m_right_key, m_user,      \
+    m_allocator                                                         \
+)                                                                       \
+    ((iter(P))iter__hash_join(                                          \
+        (m_out),                                                        \
+        iter_as_base(m_left),                                           \
+        iter_as_base(m_right),                                          \
+        (m_left_key),                                                   \
+        (m_right_key),                                                  \
+        (m_user),                                                       \
+        (m_allocator),                                                  \
+        iter_type_size(m_left),                                         \
+        offsetof(P, second),                                            \
+        iter_type_size(m_right),                                        \
+        sizeof(K)                                                       \
+    ))
+
+ITER_API iter_t *iter__hash_join(
+    iter_t *out,
+    iter_t *left,
+    iter_t *right,
+    iter_key_fn *left_key,
+    iter_key_fn *right_key,
+    void *user,
+    allocator_t *allocator,
+    size_t asize,
+    size_t boffset,
+    size_t bsize,
+    size_t ksize
+);
+
+#endif
@@ -0,0 +1,351 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_PARALLEL_H
+#define LIBITER_PARALLEL_H
+
+#include <iter/error.h>
+#include <iter/generic.h>
+#include <iter/iter.h>
+#include <iter/vector.h>
+#include <stddef.h>
+
+typedef struct allocator_t allocator_t;
+
+#ifndef ITER_API
+    #define ITER_API
+#endif
+
+#ifndef ITER_INLINE
+    #define ITER_INLINE static inline
+#endif
+
+/** # Parallel algorithms
+
+    **libiter** contains a small built-in thread pool, which is started the
+    first time a parallel function is called. Work is split into chunks that
+    are distributed between threads, and threads that run out of chunks steal
+    half of the remaining ones from others.
+
+    The number of threads can be changed with `libiter_use_threads`.
+    Parallel functions called from within a callback run on the calling
+    thread. If **libiter** is compiled with `ITER_NO_THREADS`, every
+    function in this header runs on the calling thread.
+
+    ## Grain size
+
+    Functions operating on vectors accept a `grain` argument: the number of
+    items processed as a single chunk. Grain is rounded up, so that chunks
+    start at cache line boundaries relative to the vector's buffer. If `grain`
+    is 0, a default grain is picked based only on the item size, so that
+    results don't depend on the number of threads.
+**/
+
+/** size_t libiter_use_threads(size_t count);
+
+    Sets the number of threads used by parallel functions, including the
+    calling thread, and returns the previous one. If `count` is 0, the
+    number of online processors will be used.
+
+    **This function is NOT thread-safe.**
+**/
+ITER_API size_t libiter_use_threads(size_t count);
+
+/** int parallel_for(size_t count, parallel_fn *fn, void *user);
+
+    Calls `fn` once for every index in range `[0, count)`, distributing the
+    calls between threads of the pool. Once a call returns a non-zero value,
+    no new calls are made and ITER_EINTR is returned.
+
+    ```c
+    typedef int(parallel_fn)(size_t index, void *user);
+    ```
+
+    Possible error codes: ITER_EINVAL, ITER_EINTR.
+**/
+typedef int(parallel_fn)(size_t index, void *user);
+ITER_API int parallel_for(size_t count, parallel_fn *fn, void *user);
+
+/** int vector_each_parallel(
+        vector(T) vec,
+        vector_each_fn *each,
+        void *user,
+        size_t grain
+    );
+
+    Like `vector_each`, but calls `each` from multiple threads. Once a call
+    returns a non-zero value, remaining chunks are skipped.
+
+    Possible error codes: ITER_EINVAL, ITER_EINTR.
+**/
+#define vector_each_parallel(m_vec, m_each, m_user, m_grain) \
+    vector__each_parallel(                                   \
+        vector_as_base(m_vec),                               \
+        (m_each),                                            \
+        (m_user),                                            \
+        vector_type_size(m_vec),                             \
+        (m_grain)                                            \
+    )
+
+ITER_API int vector__each_parallel(
+    vector_t *vec, vector_each_fn *each, void *user, size_t size, size_t grain
+);
+
+/** int vector_map_parallel(
+        vector(D) dst,
+        vector(S) src,
+        vector_map_fn *map,
+        void *user,
+        size_t grain
+    );
+
+    Like `vector_map`, but calls `map` from multiple threads. Mapped items
+    are appended to `dst` in the same order as their source items.
+    If a call returns a non-zero value, the length of `dst` is left unchanged.
+
+    Possible error codes: ITER_EINVAL, ITER_EINTR, ITER_ENOMEM.
+**/
+#define vector_map_parallel(m_dst, m_src, m_map, m_user, m_grain) \
+    vector__map_parallel(                                         \
+        vector_as_base(m_dst),                                    \
+        vector_as_base(m_src),                                    \
+        (m_map),                                                  \
+        (m_user),                                                 \
+        vector_type_size(m_dst),                                  \
+        vector_type_size(m_src),                                  \
+        (m_grain)                                                 \
+    )
+
+ITER_API int vector__map_parallel(
+    vector_t *dst,
+    vector_t *src,
+    vector_map_fn *map,
+    void *user,
+    size_t dsize,
+    size_t ssize,
+    size_t grain
+);
+
+/** int vector_reduce_parallel(
+        vector(T) vec,
+        T *out,
+        const T *identity,
+        vector_reduce_fn *combine,
+        void *user,
+        size_t grain
+    );
+
+    Reduces items of `vec` into `out`, by combining them with `combine`,
+    starting from `identity`. Each chunk is reduced separately and partial
+    results are then combined in order, so for an associative `combine`
+    the result is the same for any number of threads.
+
+    ```c
+    typedef int(vector_reduce_fn)(void *acc, const void *item, void *user);
+    ```
+
+    Possible error codes: ITER_EINVAL, ITER_EINTR, ITER_ENOMEM.
+**/
+#define vector_reduce_parallel(                        \
+    m_vec, m_out, m_identity, m_combine, m_user, m_grain \
+)                                                      \
+    vector__reduce_parallel(                           \
+        vector_as_base(m_vec),                         \
+        vector_check_type(m_vec, m_out),               \
+        vector_check_type(m_vec, m_identity),          \
+        (m_combine),                                   \
+        (m_user),                                      \
+        vector_type_size(m_vec),                       \
+        (m_grain)                                      \
+    )
+
+typedef int(vector_reduce_fn)(void *acc, const void *item, void *user);
+
+ITER_API int vector__reduce_parallel(
+    vector_t *vec,
+    void *out,
+    const void *identity,
+    vector_reduce_fn *combine,
+    void *user,
+    size_t size,
+    size_t grain
+);
+
+/** int iter_parallel_each(iter(T) it, vector_each_fn *each, void *user);
+
+    Divides `it` into parts with `iter_split` and traverses them from
+    multiple threads, calling `each` with a pointer to a copy of every item.
+    Items are read in batches with `iter_next_n`. Iterators that can't be
+    split are traversed on the calling thread. Once a call returns a non-zero
+    value, remaining items are skipped and ITER_EINTR is returned.
+
+    The number of parts doesn't depend on the number of threads.
+
+    Possible error codes: ITER_EINVAL, ITER_EINTR, ITER_ENOMEM.
+**/
+#define iter_parallel_each(m_iter, m_each, m_user) \
+    iter__parallel_each(                           \
+        iter_as_base(m_iter),                      \
+        (m_each),                                  \
+        (m_user),                                  \
+        iter_type_size(m_iter)                     \
+    )
+
+ITER_API int iter__parallel_each(
+    iter_t *it, vector_each_fn *each, void *user, size_t size
+);
+
+/** int iter_parallel_reduce(
+        iter(T) it,
+        T *out,
+        const T *identity,
+        vector_reduce_fn *combine,
+        void *user
+    );
+
+    Like `vector_reduce_parallel`, but reduces the items of `it`, which is
+    divided into parts like in `iter_parallel_each`. Parts are reduced
+    separately and partial results are combined in the order of the parts,
+    so for an associative `combine` the result is the same as reducing `it`
+    sequentially.
+
+    Possible error codes: ITER_EINVAL, ITER_EINTR, ITER_ENOMEM.
+**/
+#define iter_parallel_reduce(m_iter, m_out, m_identity, m_combine, m_user) \
+    iter__parallel_reduce(                                                 \
+        iter_as_base(m_iter),                                              \
+        iter_check_type(m_iter, m_out),                                    \
+        iter_check_type(m_iter, m_identity),                               \
+        (m_combine),                                                       \
+        (m_user),                                                          \
+        iter_type_size(m_iter)                                             \
+    )
+
+ITER_API int iter__parallel_reduce(
+    iter_t *it,
+    void *out,
+    const void *identity,
+    vector_reduce_fn *combine,
+    void *user,
+    size_t size
+);
+
+/** int vector_scan_inclusive(vector(T) vec, T *total);
+
+    Replaces every item of `vec` with the sum of itself and all items before
+    it. If `total` is not `NULL`, the sum of all items is stored in it.
+    `T` must be an integer type or `float`/`double`. Integer sums wrap around.
+
+    Vectors are split into blocks of a fixed size. Block sums are computed
+    in parallel first, then every block is scanned in parallel, starting from
+    the sum of the blocks before it. Blocks are scanned with SIMD additions.
+
+    > For `float` and `double`, the additions are grouped differently than
+    > in a sequential loop, so results might differ in rounding. They don't
+    > depend on the number of threads.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define vector_scan_inclusive(m_vec, m_total) \
+    vector__scan(                             \
+        vector_as_base(m_vec),                \
+        vector_check_type(m_vec, m_total),    \
+        0,                                    \
+        vector__is_float(m_vec),              \
+        vector_type_size(m_vec)               \
+    )
+
+/** int vector_scan_exclusive(vector(T) vec, T *total);
+
+    Like `vector_scan_inclusive`, but replaces every item with the sum of all
+    items before it, so the first item becomes 0. This turns a vector of
+    counts into a vector of offsets, with their `total` stored separately.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define vector_scan_exclusive(m_vec, m_total) \
+    vector__scan(                             \
+        vector_as_base(m_vec),                \
+        vector_check_type(m_vec, m_total),    \
+        1,                                    \
+        vector__is_float(m_vec),              \
+        vector_type_size(m_vec)               \
+    )
+
+#define vector__is_float(m_vec) ((vector_type(m_vec))0.5 != 0)
+
+ITER_API int vector__scan(
+    vector_t *vec, void *total, int exclusive, int is_float, size_t size
+);
+
+/** int vector_shuffle_parallel(vector(T) vec, iter_rng_t *rng);
+
+    Like `vector_shuffle`, but uses multiple threads. Every item is sent to
+    a random bucket of cache-friendly size, then buckets are shuffled
+    separately. Random streams are derived from `rng`, so the result is the
+    same for any number of threads, but differs from `vector_shuffle`.
+
+    > A temporary buffer as large as `vec` is allocated. If that fails,
+    > `vec` is shuffled in place on the calling thread instead.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define vector_shuffle_parallel(m_vec, m_rng) \
+    vector__shuffle_parallel(                 \
+        vector_as_base(m_vec),                \
+        (m_rng),                              \
+        vector_type_size(m_vec)               \
+    )
+
+ITER_API int vector__shuffle_parallel(
+    vector_t *vec, iter_rng_t *rng, size_t size
+);
+
+
+/** iter(T) iter_prefetch(
+        iter_t *out,
+        iter(T) src,
+        size_t depth,
+        allocator_t *allocator
+    );
+
+    Creates an iterator over the items of `src`, which are read ahead on a
+    background thread, so that a slow source, such as one parsing or
+    decompressing its items, runs while the caller consumes them. Items are
+    read with `iter_next_n` in batches of about 16 KiB into a ring of `depth`
+    batches. The ring has a single producer and a single consumer, so
+    batches are passed through it without locks, and the threads only sleep
+    while it's full or empty.
+
+    `src` is not owned by the iterator and must not be used by other code
+    until this iterator is exhausted or freed, since it is read from another
+    thread. Reading stops at the first batch that `src` can't fill. The
+    state is allocated with `allocator`, or the default one if `NULL`, and
+    freed once the iterator is exhausted or by `iter_free`, which waits for
+    the batch being read to complete. If the thread can't be started, or if
+    **libiter** is compiled with `ITER_NO_THREADS`, batches are read on the
+    calling thread instead. Returns `NULL` if `depth` is 0 or if out of
+    memory.
+**/
+#define iter_prefetch(m_out, m_src, m_depth, m_allocator) \
+    ((typeof(m_src))iter__prefetch(                        \
+        (m_out),                                           \
+        iter_as_base(m_src),                               \
+        (m_depth),                                         \
+        (m_allocator),                                     \
+        iter_type_size(m_src)                              \
+    ))
+
+ITER_API iter_t *iter__prefetch(
+    iter_t *out,
+    iter_t *src,
+    size_t depth,
+    allocator_t *allocator,
+    size_t size
+);
+
+#endif
@@ -0,0 +1,190 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_PIPELINE_H
+#define LIBITER_PIPELINE_H
+
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <iter/pool.h>
+#include <iter/vector.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** # Pipelines
+
+    `ITER_PIPELINE` expands a chain of stages into a single typed loop over
+    a vector, an array or a pool. Unlike adapters, no callback is called
+    through a pointer, so the compiler can inline every stage and vectorize
+    the whole loop.
+
+    ```c
+    static inline int is_even(int x) { return x % 2 == 0; }
+    static inline long square(int x) { return (long)x * x; }
+    static inline long add(long acc, long x) { return acc + x; }
+
+    long sum = ITER_PIPELINE(
+        ITER_VECTOR(numbers),
+        ITER_FILTER(is_even),
+        ITER_MAP(square),
+        ITER_REDUCE(add, 0L)
+    );
+    ```
+
+    The first argument is the source, followed by up to 7 stages, the last
+    of which must be a terminal stage. Stage arguments are called with the
+    current item as their last argument, so they can be functions or
+    function-like macros. Each stage names its item with `__auto_type`,
+    which makes pipelines a GNU C extension, like the rest of this library.
+
+    Sources:
+
+    - `ITER_VECTOR(vec)` - items of `vector(T) vec`.
+    - `ITER_ARRAY(items, length)` - the first `length` items of `items`.
+    - `ITER_POOL(pool)` - items of `pool(T) pool`, read with
+      `iter_next_span`, so free slots are skipped by bit masks.
+
+    Stages:
+
+    - `ITER_FILTER(pred)` - keeps items for which `pred(item)` is non-zero.
+    - `ITER_MAP(fn)` - replaces every item with `fn(item)`.
+
+    Terminal stages, which determine the value of the pipeline:
+
+    - `ITER_REDUCE(op, init)` - folds items with `acc = op(acc, item)`,
+      starting from `init`, and returns `acc`.
+    - `ITER_COUNT()` - returns the number of items, as `size_t`.
+    - `ITER_EACH(fn)` - calls `fn(item)` for every item, without a value.
+    - `ITER_COLLECT(vec)` - pushes items to `vector(T) vec` and returns
+      `ITER_OK`, or stops at the first error and returns it.
+**/
+#define ITER_PIPELINE(m_src, ...)                                \
+    ({                                                           \
+        __label__ iter__done;                                    \
+        ITER__EACH(ITER__BEFORE, __VA_ARGS__)                    \
+        ITER__SOURCE_BEGIN_ m_src                                \
+        {                                                        \
+            ITER__EACH(ITER__OPEN, __VA_ARGS__)                  \
+            ITER__EACH(ITER__CLOSE, __VA_ARGS__)                 \
+        }                                                        \
+        ITER__SOURCE_END_ m_src                                  \
+        iter__done: __attribute__((unused));                     \
+        ITER__EACH(ITER__AFTER, __VA_ARGS__)                     \
+    })
+
+#define ITER_VECTOR(m_vec) (VECTOR, m_vec)
+#define ITER_ARRAY(m_items, m_length) (ARRAY, m_items, m_length)
+#define ITER_POOL(m_pool) (POOL, m_pool)
+
+#define ITER_FILTER(m_pred) (FILTER, m_pred)
+#define ITER_MAP(m_fn) (MAP, m_fn)
+
+#define ITER_REDUCE(m_op, m_init) (REDUCE, m_op, m_init)
+#define ITER_COUNT() (COUNT, )
+#define ITER_EACH(m_fn) (EACH, m_fn)
+#define ITER_COLLECT(m_vec) (COLLECT, m_vec)
+
+/* Applies `m_fn` to every argument, for up to 8 arguments. */
+#define ITER__CAT(m_a, m_b) ITER__CAT_(m_a, m_b)
+#define ITER__CAT_(m_a, m_b) m_a##m_b
+#define ITER__COUNT(...) ITER__COUNT_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define ITER__COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, m_n, ...) m_n
+
+#define ITER__EACH(m_fn, ...)                                          \
+    ITER__CAT(ITER__EACH_, ITER__COUNT(__VA_ARGS__))(m_fn, __VA_ARGS__)
+
+#define ITER__EACH_1(f, a) f(a)
+#define ITER__EACH_2(f, a, ...) f(a) ITER__EACH_1(f, __VA_ARGS__)
+#define ITER__EACH_3(f, a, ...) f(a) ITER__EACH_2(f, __VA_ARGS__)
+#define ITER__EACH_4(f, a, ...) f(a) ITER__EACH_3(f, __VA_ARGS__)
+#define ITER__EACH_5(f, a, ...) f(a) ITER__EACH_4(f, __VA_ARGS__)
+#define ITER__EACH_6(f, a, ...) f(a) ITER__EACH_5(f, __VA_ARGS__)
+#define ITER__EACH_7(f, a, ...) f(a) ITER__EACH_6(f, __VA_ARGS__)
+#define ITER__EACH_8(f, a, ...) f(a) ITER__EACH_7(f, __VA_ARGS__)
+
+/*
+    Every source and stage is a tuple `(TAG, args...)`, dispatched to the
+    macro of its tag for each part of the loop.
+*/
+#define ITER__SOURCE_BEGIN_(m_tag, ...) ITER__SOURCE_BEGIN_##m_tag(__VA_ARGS__)
+#define ITER__SOURCE_END_(m_tag, ...) ITER__SOURCE_END_##m_tag(__VA_ARGS__)
+
+#define ITER__BEFORE(m_stage) ITER__BEFORE_ m_stage
+#define ITER__BEFORE_(m_tag, ...) ITER__BEFORE_##m_tag(__VA_ARGS__)
+#define ITER__OPEN(m_stage) ITER__OPEN_ m_stage
+#define ITER__OPEN_(m_tag, ...) ITER__OPEN_##m_tag(__VA_ARGS__)
+#define ITER__CLOSE(m_stage) ITER__CLOSE_ m_stage
+#define ITER__CLOSE_(m_tag, ...) ITER__CLOSE_##m_tag(__VA_ARGS__)
+#define ITER__AFTER(m_stage) ITER__AFTER_ m_stage
+#define ITER__AFTER_(m_tag, ...) ITER__AFTER_##m_tag(__VA_ARGS__)
+
+/* Sources declare `iter__x`, the current item, for the first stage. */
+#define ITER__SOURCE_BEGIN_ARRAY(m_items, m_length)                    \
+    __auto_type iter__items = (m_items);                               \
+    size_t iter__length = (m_length);                                  \
+    for (size_t iter__i = 0; iter__i < iter__length; iter__i++) {      \
+        __auto_type iter__x = iter__items[iter__i];
+#define ITER__SOURCE_END_ARRAY(m_items, m_length) }
+
+#define ITER__SOURCE_BEGIN_VECTOR(m_vec)                               \
+    ITER__SOURCE_BEGIN_ARRAY(vector_items(m_vec), vector_length(m_vec))
+#define ITER__SOURCE_END_VECTOR(m_vec) }
+
+#define ITER__SOURCE_BEGIN_POOL(m_pool)                                \
+    iter_t iter__storage;                                              \
+    __auto_type iter__it = pool_iter(m_pool, &iter__storage);          \
+    const pool_type(m_pool) *iter__items;                              \
+    size_t iter__length;                                               \
+    uint64_t iter__mask;                                               \
+    while (iter__it                                                    \
+           && !iter_next_span(                                         \
+               iter__it, &iter__items, &iter__length, &iter__mask      \
+           )) {                                                        \
+        for (size_t iter__i = 0; iter__i < iter__length; iter__i++) {  \
+            if (iter__i < 64 && !(iter__mask >> iter__i & 1))          \
+                continue;                                              \
+            __auto_type iter__x = iter__items[iter__i];
+#define ITER__SOURCE_END_POOL(m_pool) }}
+
+/* Stages shadow `iter__x` with their own item, inside a new block. */
+#define ITER__BEFORE_FILTER(m_pred)
+#define ITER__OPEN_FILTER(m_pred) if (m_pred(iter__x)) {
+#define ITER__CLOSE_FILTER(m_pred) }
+#define ITER__AFTER_FILTER(m_pred)
+
+#define ITER__BEFORE_MAP(m_fn)
+#define ITER__OPEN_MAP(m_fn)                                           \
+    {                                                                  \
+        __auto_type iter__y = m_fn(iter__x);                           \
+        {                                                              \
+            __auto_type iter__x = iter__y;
+#define ITER__CLOSE_MAP(m_fn) }}
+#define ITER__AFTER_MAP(m_fn)
+
+#define ITER__BEFORE_REDUCE(m_op, m_init) __auto_type iter__acc = (m_init);
+#define ITER__OPEN_REDUCE(m_op, m_init) iter__acc = m_op(iter__acc, iter__x);
+#define ITER__CLOSE_REDUCE(m_op, m_init)
+#define ITER__AFTER_REDUCE(m_op, m_init) iter__acc;
+
+#define ITER__BEFORE_COUNT(...) size_t iter__count = 0;
+#define ITER__OPEN_COUNT(...) (void)iter__x, iter__count++;
+#define ITER__CLOSE_COUNT(...)
+#define ITER__AFTER_COUNT(...) iter__count;
+
+#define ITER__BEFORE_EACH(m_fn)
+#define ITER__OPEN_EACH(m_fn) m_fn(iter__x);
+#define ITER__CLOSE_EACH(m_fn)
+#define ITER__AFTER_EACH(m_fn)
+
+#define ITER__BEFORE_COLLECT(m_vec) int iter__status = ITER_OK;
+#define ITER__OPEN_COLLECT(m_vec)                                      \
+    if ((iter__status = vector_push(m_vec, &iter__x, 1)))              \
+        goto iter__done;
+#define ITER__CLOSE_COLLECT(m_vec)
+#define ITER__AFTER_COLLECT(m_vec) iter__status;
+
+#endif
@@ -0,0 +1,105 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_RANDOM_H
+#define LIBITER_RANDOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef ITER_API
+    #define ITER_API
+#endif
+
+#ifndef ITER_INLINE
+    #define ITER_INLINE static inline
+#endif
+
+/** # Random numbers
+
+    `iter_rng_t` is the state of a xoshiro256** generator, used by functions
+    that shuffle or sample containers. It's fast and statistically strong,
+    but **not** cryptographically secure.
+
+    The state is owned by the caller, so the results are reproducible for
+    the same seed. Functions using multiple threads derive their streams from
+    the provided state, so their results don't depend on the thread count.
+**/
+
+typedef struct iter_rng_t {
+    uint64_t s[4];
+} iter_rng_t;
+
+/** void iter_rng_seed(iter_rng_t *rng, uint64_t seed);
+
+    Initializes `rng` from `seed`, by expanding it with splitmix64.
+**/
+ITER_API void iter_rng_seed(iter_rng_t *rng, uint64_t seed);
+
+/** void iter_rng_jump(iter_rng_t *rng);
+
+    Advances `rng` by 2^128 steps, which can be used to create
+    non-overlapping streams for multiple threads.
+**/
+ITER_API void iter_rng_jump(iter_rng_t *rng);
+
+ITER_INLINE uint64_t iter__rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/** uint64_t iter_rng_next(iter_rng_t *rng);
+
+    Returns the next 64 random bits from `rng`.
+**/
+ITER_INLINE uint64_t iter_rng_next(iter_rng_t *rng) {
+    uint64_t *s = rng->s;
+    uint64_t out = iter__rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = iter__rotl(s[3], 45);
+
+    return out;
+}
+
+/** uint64_t iter_rng_bounded(iter_rng_t *rng, uint64_t bound);
+
+    Returns a uniformly distributed number in range `[0, bound)`,
+    or 0 if `bound` is 0. Uses Lemire's multiply-shift rejection method,
+    which rarely needs more than one call to `iter_rng_next`.
+**/
+ITER_INLINE uint64_t iter_rng_bounded(iter_rng_t *rng, uint64_t bound) {
+    if (bound == 0)
+        return 0;
+
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 m = (unsigned __int128)iter_rng_next(rng) * bound;
+
+    if ((uint64_t)m < bound) {
+        uint64_t threshold = -bound % bound;
+
+        while ((uint64_t)m < threshold)
+            m = (unsigned __int128)iter_rng_next(rng) * bound;
+    }
+
+    return (uint64_t)(m >> 64);
+#else
+    uint64_t threshold = -bound % bound, r;
+
+    do {
+        r = iter_rng_next(rng);
+    } while (r < threshold);
+
+    return r % bound;
+#endif
+}
+
+#endif
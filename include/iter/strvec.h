@@ -0,0 +1,188 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_STRVEC_H
+#define LIBITER_STRVEC_H
+
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <iter/vector.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct allocator_t allocator_t;
+
+#ifndef ITER_API
+    #define ITER_API
+#endif
+
+#ifndef ITER_INLINE
+    #define ITER_INLINE static inline
+#endif
+
+/** # strvec_t - Contiguous string vectors
+
+    strvec_t is a growable array of byte strings. Instead of allocating every
+    string separately, the bytes of all strings are stored back to back in
+    a single buffer and every string is referenced by its offset and length.
+
+    Each string is followed by a `'\0'`, so strings returned by `strvec_get`
+    can be passed to functions expecting C strings, as long as they don't
+    contain a `'\0'` themselves.
+
+    Like with `vector(T)`, pushing strings might move the buffer, so you
+    should store indexes of strings instead of pointers.
+
+    Offsets and lengths are 32-bit, so every string costs 8 bytes on top of
+    its bytes and terminator, and all strings of a `strvec_t` together can't
+    take more than `STRVEC_MAX_BYTES` (4 GiB - 1) bytes, terminators included.
+**/
+
+#define STRVEC_MAX_BYTES ((size_t)UINT32_MAX)
+
+typedef struct strvec_span_t {
+    uint32_t offset;
+    uint32_t length;
+} strvec_span_t;
+
+typedef struct strvec_t {
+    vector_t bytes;
+    vector_t spans;
+} strvec_t;
+
+/** typedef struct strvec_item_t;
+
+    Item returned by iterators over strings of a `strvec_t`.
+**/
+typedef struct strvec_item_t {
+    const char *str;
+    size_t length;
+} strvec_item_t;
+
+/** strvec_t *strvec_init(strvec_t *out, allocator_t *allocator);
+
+    Initializes `out` as an empty string vector, allocating memory with
+    `allocator`. If `allocator` is `NULL`, the default one will be used.
+
+    > You should use `strvec_free` instead of `strvec_destroy`
+    > to free the resources of `out`.
+**/
+ITER_API strvec_t *strvec_init(strvec_t *out, allocator_t *allocator);
+
+/** void strvec_free(strvec_t *sv);
+
+    Frees all resources used by `sv`, which was initialized by `strvec_init`
+    beforehand, if it's not `NULL`.
+**/
+ITER_API void strvec_free(strvec_t *sv);
+
+/** strvec_t *strvec_create(allocator_t *allocator);
+
+    Creates a new instance of `strvec_t`, allocated with `allocator`.
+    Returns `NULL` if out of memory.
+
+    > If `allocator` is `NULL`, the default one will be used.
+**/
+ITER_API strvec_t *strvec_create(allocator_t *allocator);
+
+/** void strvec_destroy(strvec_t *sv);
+
+    Frees all resources used by `sv` if it's not `NULL`.
+**/
+ITER_API void strvec_destroy(strvec_t *sv);
+
+/** size_t strvec_length(const strvec_t *sv);
+
+    Returns number of strings present in `sv` or 0 if `sv` is `NULL`.
+**/
+ITER_INLINE size_t strvec_length(const strvec_t *sv) {
+    return sv ? sv->spans.length / sizeof(strvec_span_t) : 0;
+}
+
+/** size_t strvec_bytes_used(const strvec_t *sv);
+
+    Returns number of bytes used by strings in `sv`, including terminators.
+**/
+ITER_INLINE size_t strvec_bytes_used(const strvec_t *sv) {
+    return sv ? sv->bytes.length : 0;
+}
+
+/** void strvec_clear(strvec_t *sv);
+
+    Removes all strings from `sv`, if it's not `NULL`.
+**/
+ITER_INLINE void strvec_clear(strvec_t *sv) {
+    if (sv)
+        sv->bytes.length = sv->spans.length = 0;
+}
+
+/** int strvec_reserve(strvec_t *sv, size_t count, size_t bytes);
+
+    Reserves space to fit at least `count` more strings, which are `bytes`
+    bytes long in total, without resizing the buffers. Fails with
+    ITER_ENOMEM if they would grow past `STRVEC_MAX_BYTES`.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+ITER_API int strvec_reserve(strvec_t *sv, size_t count, size_t bytes);
+
+/** int strvec_push(strvec_t *sv, const char *str, size_t length);
+
+    Appends the first `length` bytes of `str` to the end of `sv`.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+ITER_API int strvec_push(strvec_t *sv, const char *str, size_t length);
+
+/** const char *strvec_get(const strvec_t *sv, size_t i, size_t *length);
+
+    Returns pointer to the string at index `i` or `NULL` if out of bounds.
+    If `length` is not `NULL`, the length of the string is stored in it.
+
+    > This pointer is valid until a string is pushed or `sv` is destroyed.
+**/
+ITER_API const char *strvec_get(const strvec_t *sv, size_t i, size_t *length);
+
+/** int strvec_load_lines(strvec_t *sv, const char *buffer, size_t size);
+
+    Splits the first `size` bytes of `buffer` on `'\n'` and appends every
+    line, without the newline, to `sv`. The last line is only appended if
+    it's not empty. Both buffers are resized at most once.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+ITER_API int strvec_load_lines(strvec_t *sv, const char *buffer, size_t size);
+
+/** int strvec_sort(strvec_t *sv, strvec_compare_fn *compare);
+
+    Sorts strings of `sv` with a stable merge sort. Only the offsets are
+    reordered, the bytes of the strings are never moved. If `compare` is
+    `NULL`, strings are compared byte by byte, with shorter prefixes first.
+
+    ```c
+    typedef int(strvec_compare_fn)(
+        const char *lhs, size_t lhs_length, const char *rhs, size_t rhs_length
+    );
+    ```
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+typedef int(strvec_compare_fn)(
+    const char *lhs, size_t lhs_length, const char *rhs, size_t rhs_length
+);
+
+ITER_API int strvec_sort(strvec_t *sv, strvec_compare_fn *compare);
+
+/** iter(strvec_item_t) strvec_iter(const strvec_t *sv, iter_t *out);
+
+    Initializes `out` as an iterator traversing strings present in `sv`.
+
+    > Pushing strings to `sv` doesn't invalidate the returned iterator.
+**/
+ITER_API iter(strvec_item_t) strvec_iter(const strvec_t *sv, iter_t *out);
+
+#endif
@@ -10,6 +10,8 @@
 
 #include <iter/error.h>
 #include <iter/generic.h>
+#include <iter/hash.h>
+#include <iter/random.h>
 
 typedef struct allocator_t allocator_t;
 #include <stddef.h>
@@ -43,17 +45,34 @@ typedef struct vector_t {
     size_t length;
     size_t capacity;
     allocator_t *allocator;
+    struct vector_buffer *shared;
+    size_t align;
 } vector_t;
 
+/** ## Slices
+
+    `vector_slice` creates a vector that views a range of another vector's
+    items without copying them. The buffer is shared and reference counted,
+    so both vectors can be destroyed in any order.
+
+    Functions that write to items, like `vector_insert` or `vector_sort`,
+    copy the shared items into a private buffer first. Pointers returned by
+    `vector_get`, `vector_slot` and `vector_items` point into the shared
+    buffer, so call `vector_unshare` before writing through them.
+
+    > Sharing is not synchronized beyond the reference count, vectors sharing
+    > a buffer can be read from multiple threads but not written to.
+**/
+
 /** ## Alignment
 
-    Unlike other containers, to keep the implementation of vectors simple,
-    the alignment of types is not explicitly handled and can cause problems
-    for over-aligned types, like SIMD vectors.
+    By default, the alignment of items is whatever the allocator provides.
+    Vectors created with `vector_with_alignment` over-allocate their buffer
+    instead, so that `vector_items` is aligned to the requested boundary,
+    e.g. 64 bytes for AVX-512 or a cache line, even after resizing.
 
-    However, you can still use vectors in these situations if you handle
-    the alignment correctly in a custom allocator that is passed to the vector,
-    e.g. you can use `allocator_aligned.h` by passing a minimum alignment.
+    Alternatively, you can handle the alignment in a custom allocator that
+    is passed to the vector, e.g. `allocator_aligned.h`.
 **/
 
 #define vector_type(m_vec) generic_value_type(vector_t, m_vec)
@@ -120,6 +139,28 @@ ITER_API vector_t *vector__create(allocator_t *allocator);
 
 ITER_API vector_t *vector__with_capacity(size_t cap, allocator_t *allocator);
 
+/** vector(T) vector_with_alignment(
+        type T, size_t cap, size_t align, allocator_t *allocator
+    );
+
+    Creates a new instance of `vector(T)` whose items are always aligned
+    to `align` bytes, which must be a power of two, with space for `cap`
+    items. Returns `NULL` if out of memory or if `align` is invalid.
+
+    > Vectors created with this function can't be unwrapped,
+    > since their buffer doesn't start at `vector_items`.
+**/
+#define vector_with_alignment(T, m_capacity, m_align, m_allocator)        \
+    ((vector(T))vector__with_alignment(                                   \
+        vector__checked_umulsize(sizeof(T), (m_capacity)),                \
+        (m_align),                                                        \
+        (m_allocator)                                                     \
+    ))
+
+ITER_API vector_t *vector__with_alignment(
+    size_t cap, size_t align, allocator_t *allocator
+);
+
 /** vector(T) vector_from_array(T *array, size_t len, allocator_t *allocator);
 
     Creates a new vector with type `T` and copies `len` items from `array`.
@@ -140,6 +181,8 @@ ITER_API vector_t *vector__from_array(
 /** vector(T) vector_from_iter(iter(T) it, allocator_t *allocator)
 
     Creates a new vector with type `T` and inserts all items from `it`.
+    The vector is presized to the lower bound of `iter_size_hint`, so items
+    of iterators with exact hints are collected with a single allocation.
     Returns `NULL` if out of memory or `sizeof(T) == 0`.
 **/
 #define vector_from_iter(m_it, m_allocator)                     \
@@ -185,10 +228,41 @@ ITER_INLINE vector_t *vector__clone(
     return vec ? vector__from_array(vec->items, vec->length, allocator) : NULL;
 }
 
+/** vector(T) vector_slice(vector(T) vec, size_t from, size_t to);
+
+    Creates a new `vector(T)` that views items of `vec` in range
+    `[from, to)` without copying them. The slice uses the same allocator
+    as `vec` and its capacity equals its length.
+
+    Returns `NULL` if out of memory or if the range is out of bounds.
+**/
+#define vector_slice(m_vec, m_from, m_to)    \
+    ((typeof(m_vec))vector__slice(           \
+        vector_as_base(m_vec),               \
+        vector_type_mul(m_vec, m_from),      \
+        vector_type_mul(m_vec, m_to)         \
+    ))
+
+ITER_API vector_t *vector__slice(vector_t *vec, size_t from, size_t to);
+
+/** int vector_unshare(vector(T) vec);
+
+    Makes sure that `vec` owns its items, copying them into a new buffer
+    if they are shared with other vectors. If `vec` is the last one using
+    a shared buffer, the buffer is taken over without copying.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define vector_unshare(m_vec) vector__unshare(vector_as_base(m_vec))
+ITER_API int vector__unshare(vector_t *vec);
+
 /** T *vector_unwrap(vector(T) vec);
 
     Destroys the `vector` without deallocating it's items, returning
     the array instead. If vector's capacity is 0, `NULL` is returned.
+    If items are shared, they are copied first and `NULL` is returned
+    if out of memory, leaving `vec` intact. `NULL` is also returned,
+    without destroying `vec`, if it was created with an alignment.
 **/
 #define vector_unwrap(m_vec)                                        \
     ((vector_type_ptr(m_vec))vector__unwrap(vector_as_base(m_vec)))
@@ -530,6 +604,9 @@ ITER_API int vector__swap_remove(vector_t *vec, size_t i, size_t size);
 /** int vector_swap(vector(T) vec, size_t i, size_t j, size_t count);
 
     Swaps `count` items starting at index `i` with items at index `j`.
+    The ranges must not overlap. ITER_ENOMEM is only returned if `vec`
+    shares its items and they can't be copied.
+
     Possible error codes: ITER_EINVAL, ITER_ENOMEM.
 **/
 #define vector_swap(m_vec, m_i, m_j, m_count) \
@@ -662,6 +739,10 @@ ITER_API iter_t *vector__iter_ref(vector_t *vec, iter_t *out, size_t size);
     Sorts items inside `vec` according to the provided comparison function.
     This function always uses a stable sorting algorithm, currently mergesort.
 
+    Scratch space for half of the items is allocated with vector's allocator.
+    If it can't be allocated, items are sorted in place instead, which is
+    slower, but never fails with ITER_ENOMEM for vectors that aren't shared.
+
     ```c
     typedef int(vector_compare_fn)(const void *lhs, const void *rhs, size_t s);
     ```
@@ -680,6 +761,34 @@ ITER_API int vector__sort(
     vector_t *vec, vector_compare_fn *compare, size_t size
 );
 
+/** int vector_sort_with_buffer(
+        vector(T) vec, vector_compare_fn *cmp, T *scratch, size_t length
+    );
+
+    Like `vector_sort`, but uses `length` items of `scratch` as temporary
+    space and never allocates. Any `length` works, including 0, in which case
+    items are merged in place with rotations. Sorting is fastest when
+    `scratch` fits half of the items of `vec`.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define vector_sort_with_buffer(m_vec, m_cmp, m_scratch, m_length) \
+    vector__sort_with_buffer(                                      \
+        vector_as_base(m_vec),                                     \
+        (m_cmp),                                                   \
+        vector_check_type(m_vec, m_scratch),                       \
+        vector_type_mul(m_vec, m_length),                          \
+        vector_type_size(m_vec)                                    \
+    )
+
+ITER_API int vector__sort_with_buffer(
+    vector_t *vec,
+    vector_compare_fn *compare,
+    void *buffer,
+    size_t length,
+    size_t size
+);
+
 /** int vector_is_sorted(vector(T) vec, vector_compare_fn *cmp);
 
     Checks if items inside `vec` are sorted according to the `cmp` function.
@@ -702,4 +811,177 @@ ITER_API int vector__is_sorted(
     vector_t *vec, vector_compare_fn *compare, size_t size
 );
 
+/** size_t vector_unique(vector(T) vec, vector_compare_fn *cmp);
+
+    Removes consecutive duplicate items from `vec` in place, keeping the
+    first item of every run, and returns the new length. For sorted vectors,
+    this removes all duplicates. If `cmp` is `NULL`, items are compared with
+    `memcmp` and, for 1, 2, 4 and 8 byte items, with SIMD instructions.
+**/
+#define vector_unique(m_vec, m_cmp)                                           \
+    (vector__unique(vector_as_base(m_vec), (m_cmp), vector_type_size(m_vec)) \
+     / vector_type_size(m_vec))
+
+ITER_API size_t vector__unique(
+    vector_t *vec, vector_compare_fn *compare, size_t size
+);
+
+/** size_t vector_dedup_unsorted(vector(T) vec, hash_fn *hash);
+
+    Removes all duplicate items from `vec` in place, keeping the first
+    occurrence of each item in its original order, and returns the new length.
+    Items are tracked in a temporary table of indexes, hashed and compared
+    with `hash`. If `hash` is `NULL`, the default hasher and `memcmp` are used.
+
+    > The table holds two indexes per item. If it can't be allocated, `vec`
+    > is left unchanged and its current length is returned.
+**/
+#define vector_dedup_unsorted(m_vec, m_hash)                      \
+    (vector__dedup_unsorted(                                      \
+         vector_as_base(m_vec), (m_hash), vector_type_size(m_vec) \
+     )                                                            \
+     / vector_type_size(m_vec))
+
+ITER_API size_t vector__dedup_unsorted(
+    vector_t *vec, hash_fn *hash, size_t size
+);
+
+/** int vector_merge_k(
+        vector(T) out,
+        vector(T) *inputs,
+        size_t k,
+        vector_compare_fn *cmp
+    );
+
+    Merges `k` vectors from `inputs`, each of them sorted according to `cmp`,
+    appending their items to `out` in sorted order. Items are selected with
+    a loser tree, making the merge `O(n log k)`. Equal items are appended
+    in the order of their inputs. `out` must not be one of the inputs.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define vector_merge_k(m_out, m_inputs, m_k, m_cmp) \
+    vector__merge_k(                                \
+        vector_as_base(m_out),                      \
+        (vector_t **)(m_inputs),                    \
+        (m_k),                                      \
+        vector_type_size(m_out),                    \
+        (m_cmp)                                     \
+    )
+
+ITER_API int vector__merge_k(
+    vector_t *out,
+    vector_t **inputs,
+    size_t k,
+    size_t size,
+    vector_compare_fn *cmp
+);
+
+/** int vector_shuffle(vector(T) vec, iter_rng_t *rng);
+
+    Randomly permutes the items of `vec` with the Fisher-Yates shuffle,
+    drawing random numbers from `rng`. Every permutation is equally likely.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define vector_shuffle(m_vec, m_rng)                                         \
+    vector__shuffle(vector_as_base(m_vec), (m_rng), vector_type_size(m_vec))
+
+ITER_API int vector__shuffle(vector_t *vec, iter_rng_t *rng, size_t size);
+
+/** int vector_sample_k(
+        vector(T) dst, vector(T) src, size_t k, iter_rng_t *rng
+    );
+
+    Appends `k` items of `src`, picked uniformly at random without
+    replacement, to `dst`. The order of the appended items is random.
+    Picks are made with a partial Fisher-Yates shuffle over the indexes of
+    `src`, storing only the moved indexes, so `src` is not modified and
+    only `O(k)` memory is used. `dst` must not be `src`.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define vector_sample_k(m_dst, m_src, m_k, m_rng) \
+    vector__sample_k(                             \
+        vector_as_base(m_dst),                    \
+        vector_as_base(m_src),                    \
+        (m_k),                                    \
+        (m_rng),                                  \
+        vector_type_size(m_dst)                   \
+    )
+
+ITER_API int vector__sample_k(
+    vector_t *dst, const vector_t *src, size_t k, iter_rng_t *rng, size_t size
+);
+
+/** int iter_reservoir_sample(
+        vector(T) dst, iter(T) src, size_t k, iter_rng_t *rng
+    );
+
+    Appends `k` items of `src`, picked uniformly at random without
+    replacement, to `dst`, or all of them if `src` has fewer than `k`.
+    Unlike `vector_sample_k`, the number of items doesn't have to be known,
+    so `src` can be a stream. Picks are made with Algorithm L, which draws
+    the number of items to skip before the next replacement and skips them
+    with `iter_advance`, reading only `O(k(1 + log(n / k)))` of `n` items
+    from sources that skip natively, like arrays and file records.
+    The order of the appended items is unspecified.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define iter_reservoir_sample(m_dst, m_src, m_k, m_rng) \
+    vector__reservoir_sample(                           \
+        vector_as_base(m_dst),                          \
+        iter_as_base(m_src),                            \
+        (m_k),                                          \
+        (m_rng),                                        \
+        vector_type_size(m_dst)                         \
+    )
+
+ITER_API int vector__reservoir_sample(
+    vector_t *dst, iter_t *src, size_t k, iter_rng_t *rng, size_t size
+);
+
+/** int iter_top_k(
+        vector(T) dst, iter(T) src, size_t k, vector_compare_fn *cmp
+    );
+
+    Appends the first `k` items of `src` in the order of `cmp` to `dst`,
+    sorted, or all of them if `src` has fewer than `k`. Items are selected
+    in a single pass with a heap bounded to `k` items, so `src` can be
+    a stream. Which of equal items are kept is unspecified.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define iter_top_k(m_dst, m_src, m_k, m_cmp) \
+    vector__top_k(                           \
+        vector_as_base(m_dst),               \
+        iter_as_base(m_src),                 \
+        (m_k),                               \
+        (m_cmp),                             \
+        vector_type_size(m_dst)              \
+    )
+
+ITER_API int vector__top_k(
+    vector_t *dst, iter_t *src, size_t k, vector_compare_fn *cmp, size_t size
+);
+
+/** int vector_apply_permutation(vector(T) vec, const size_t *perm);
+
+    Reorders items of `vec`, so that the item at index `i` becomes the item
+    previously at index `perm[i]`. `perm` must contain every index of `vec`
+    exactly once. Items are moved in place by following the cycles of `perm`,
+    using one temporary item and a bit per item to mark visited indexes.
+
+    Possible error codes: ITER_EINVAL, ITER_ENOMEM.
+**/
+#define vector_apply_permutation(m_vec, m_perm)                  \
+    vector__apply_permutation(                                   \
+        vector_as_base(m_vec), (m_perm), vector_type_size(m_vec) \
+    )
+
+ITER_API int vector__apply_permutation(
+    vector_t *vec, const size_t *perm, size_t size
+);
+
 #endif
@@ -0,0 +1,513 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <pf_macro.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/iter.h>
+
+extern allocator_t *libiter_allocator;
+
+/* Items read only to be inspected or dropped are kept on the stack. */
+#define ITEM_STACK 256
+
+union item_stack {
+    max_align_t align;
+    unsigned char bytes[ITEM_STACK];
+};
+
+static void *item_acquire(union item_stack *stack, size_t size) {
+    return size <= ITEM_STACK ? stack : allocate(libiter_allocator, size);
+}
+
+static void item_release(union item_stack *stack, void *item, size_t size) {
+    if (item && item != (void *)stack)
+        deallocate(libiter_allocator, item, size);
+}
+
+static iter_t *adapter_init(
+    iter_t *out, iter_fn *call, const struct iter_ops *ops
+) {
+    out->call = call;
+    out->ops = ops;
+    return out;
+}
+
+/* `SIZE_MAX` stands for an unknown upper bound, so sums saturate at it. */
+static inline size_t add_saturated(size_t a, size_t b) {
+    return a > SIZE_MAX - b ? SIZE_MAX : a + b;
+}
+
+struct map_iter {
+    iter_t *src;
+    iter_map_fn *map;
+    void *user;
+    size_t ssize;
+};
+
+ITER__ASSERT_FITS(struct map_iter);
+
+static int map_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it || size == 0)
+        return ITER_EINVAL;
+
+    if (it == out)
+        return ITER_OK;
+
+    struct map_iter *mit = ITER__CAST(it);
+
+    if (!out)
+        return iter__call(mit->src, NULL, mit->ssize, skip);
+
+    union item_stack stack;
+    void *item = item_acquire(&stack, mit->ssize);
+    if (!item)
+        return ITER_ENOMEM;
+
+    int status = iter__call(mit->src, item, mit->ssize, skip);
+    if (!status && mit->map(out, item, mit->user))
+        status = ITER_EINTR;
+
+    item_release(&stack, item, mit->ssize);
+    return status;
+}
+
+static void map_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    struct map_iter *mit = ITER__CAST(it);
+    iter__size_hint(mit->src, lower, upper, mit->ssize);
+}
+
+static const struct iter_ops map_iter_ops = {
+    NULL,
+    NULL,
+    NULL,
+    map_size_hint,
+};
+
+iter_t *iter__map(
+    iter_t *out, iter_t *src, iter_map_fn *map, void *user, size_t ssize
+) {
+    if (!out || !src || !map || ssize == 0)
+        return NULL;
+
+    struct map_iter *mit = ITER__CAST(out);
+    mit->src = src;
+    mit->map = map;
+    mit->user = user;
+    mit->ssize = ssize;
+    return adapter_init(out, map_iter_fn, &map_iter_ops);
+}
+
+struct filter_iter {
+    iter_t *src;
+    iter_filter_fn *filter;
+    void *user;
+};
+
+ITER__ASSERT_FITS(struct filter_iter);
+
+static int filter_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it || size == 0)
+        return ITER_EINVAL;
+
+    if (it == out || (!out && skip == 0))
+        return ITER_OK;
+
+    struct filter_iter *fit = ITER__CAST(it);
+    union item_stack stack;
+
+    /* `out` is only written once an item is accepted. */
+    void *item = item_acquire(&stack, size);
+    if (!item)
+        return ITER_ENOMEM;
+
+    size_t wanted = skip + (out ? 1 : 0);
+    int status = ITER_OK;
+
+    while (wanted > 0 && !(status = iter__call(fit->src, item, size, 0))) {
+        if (fit->filter(item, fit->user))
+            wanted--;
+    }
+
+    if (!status && out)
+        memcpy(out, item, size);
+
+    item_release(&stack, item, size);
+    return status;
+}
+
+static void filter_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    struct filter_iter *fit = ITER__CAST(it);
+    iter__size_hint(fit->src, NULL, upper, size);
+    *lower = 0;
+}
+
+static const struct iter_ops filter_iter_ops = {
+    NULL,
+    NULL,
+    NULL,
+    filter_size_hint,
+};
+
+iter_t *iter__filter(
+    iter_t *out, iter_t *src, iter_filter_fn *filter, void *user
+) {
+    if (!out || !src || !filter)
+        return NULL;
+
+    struct filter_iter *fit = ITER__CAST(out);
+    fit->src = src;
+    fit->filter = filter;
+    fit->user = user;
+    return adapter_init(out, filter_iter_fn, &filter_iter_ops);
+}
+
+struct take_iter {
+    iter_t *src;
+    size_t left;
+};
+
+ITER__ASSERT_FITS(struct take_iter);
+
+static int take_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it || size == 0)
+        return ITER_EINVAL;
+
+    if (it == out)
+        return ITER_OK;
+
+    struct take_iter *tit = ITER__CAST(it);
+    size_t wanted = skip + (out ? 1 : 0);
+
+    if (wanted < skip || wanted > tit->left) {
+        tit->left = 0;
+        return ITER_ENODATA;
+    }
+
+    int status = iter__call(tit->src, out, size, skip);
+    tit->left = status ? 0 : tit->left - wanted;
+    return status;
+}
+
+static void take_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    struct take_iter *tit = ITER__CAST(it);
+    iter__size_hint(tit->src, lower, upper, size);
+    *lower = PF_MIN(*lower, tit->left);
+    *upper = PF_MIN(*upper, tit->left);
+}
+
+static const struct iter_ops take_iter_ops = {
+    NULL,
+    NULL,
+    NULL,
+    take_size_hint,
+};
+
+iter_t *iter__take(iter_t *out, iter_t *src, size_t count) {
+    if (!out || !src)
+        return NULL;
+
+    struct take_iter *tit = ITER__CAST(out);
+    tit->src = src;
+    tit->left = count;
+    return adapter_init(out, take_iter_fn, &take_iter_ops);
+}
+
+struct skip_iter {
+    iter_t *src;
+    size_t pending;
+};
+
+ITER__ASSERT_FITS(struct skip_iter);
+
+static int skip_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it || size == 0)
+        return ITER_EINVAL;
+
+    if (it == out)
+        return ITER_OK;
+
+    struct skip_iter *sit = ITER__CAST(it);
+
+    if (sit->pending > SIZE_MAX - skip)
+        return ITER_EINVAL;
+
+    skip += sit->pending;
+    sit->pending = 0;
+    return iter__call(sit->src, out, size, skip);
+}
+
+static void skip_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    struct skip_iter *sit = ITER__CAST(it);
+    iter__size_hint(sit->src, lower, upper, size);
+    *lower = *lower > sit->pending ? *lower - sit->pending : 0;
+
+    if (*upper != SIZE_MAX)
+        *upper = *upper > sit->pending ? *upper - sit->pending : 0;
+}
+
+static const struct iter_ops skip_iter_ops = {
+    NULL,
+    NULL,
+    NULL,
+    skip_size_hint,
+};
+
+iter_t *iter__skip(iter_t *out, iter_t *src, size_t count) {
+    if (!out || !src)
+        return NULL;
+
+    struct skip_iter *sit = ITER__CAST(out);
+    sit->src = src;
+    sit->pending = count;
+    return adapter_init(out, skip_iter_fn, &skip_iter_ops);
+}
+
+struct chain_iter {
+    iter_t *first;
+    iter_t *second;
+};
+
+ITER__ASSERT_FITS(struct chain_iter);
+
+static int chain_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it || size == 0)
+        return ITER_EINVAL;
+
+    if (it == out)
+        return ITER_OK;
+
+    struct chain_iter *cit = ITER__CAST(it);
+    union item_stack stack;
+    void *item = NULL;
+    int status = ITER_OK;
+
+    /* the length of `first` is unknown, so its items are skipped one by one. */
+    while (cit->first && skip > 0) {
+        if (!item && !(item = item_acquire(&stack, size)))
+            return ITER_ENOMEM;
+
+        status = iter__call(cit->first, item, size, 0);
+        if (status == ITER_ENODATA)
+            cit->first = NULL;
+        else if (status)
+            break;
+        else
+            skip--;
+    }
+
+    item_release(&stack, item, size);
+
+    if (status && status != ITER_ENODATA)
+        return status;
+
+    if (cit->first) {
+        status = iter__call(cit->first, out, size, 0);
+        if (status != ITER_ENODATA)
+            return status;
+
+        cit->first = NULL;
+    }
+
+    return iter__call(cit->second, out, size, skip);
+}
+
+static void chain_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    struct chain_iter *cit = ITER__CAST(it);
+    size_t lo = 0, hi = 0;
+
+    iter__size_hint(cit->second, lower, upper, size);
+    if (cit->first)
+        iter__size_hint(cit->first, &lo, &hi, size);
+
+    *lower = add_saturated(*lower, lo);
+    *upper = add_saturated(*upper, hi);
+}
+
+static const struct iter_ops chain_iter_ops = {
+    NULL,
+    NULL,
+    NULL,
+    chain_size_hint,
+};
+
+iter_t *iter__chain(iter_t *out, iter_t *first, iter_t *second) {
+    if (!out || !first || !second)
+        return NULL;
+
+    struct chain_iter *cit = ITER__CAST(out);
+    cit->first = first;
+    cit->second = second;
+    return adapter_init(out, chain_iter_fn, &chain_iter_ops);
+}
+
+struct zip_iter {
+    iter_t *a, *b;
+    size_t asize, boffset, bsize;
+};
+
+ITER__ASSERT_FITS(struct zip_iter);
+
+static int zip_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it || size == 0)
+        return ITER_EINVAL;
+
+    if (it == out)
+        return ITER_OK;
+
+    struct zip_iter *zit = ITER__CAST(it);
+
+    if (size < zit->boffset + zit->bsize)
+        return ITER_EINVAL;
+
+    void *second = out ? PF_OFFSET(out, zit->boffset) : NULL;
+    int status = iter__call(zit->a, out, zit->asize, skip);
+
+    return status ? status : iter__call(zit->b, second, zit->bsize, skip);
+}
+
+static void zip_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    struct zip_iter *zit = ITER__CAST(it);
+    size_t lo, hi;
+
+    iter__size_hint(zit->a, lower, upper, zit->asize);
+    iter__size_hint(zit->b, &lo, &hi, zit->bsize);
+
+    *lower = PF_MIN(*lower, lo);
+    *upper = PF_MIN(*upper, hi);
+}
+
+static const struct iter_ops zip_iter_ops = {
+    NULL,
+    NULL,
+    NULL,
+    zip_size_hint,
+};
+
+iter_t *iter__zip(
+    iter_t *out,
+    iter_t *a,
+    iter_t *b,
+    size_t asize,
+    size_t boffset,
+    size_t bsize
+) {
+    if (!out || !a || !b || asize == 0 || bsize == 0 || boffset < asize)
+        return NULL;
+
+    struct zip_iter *zit = ITER__CAST(out);
+    zit->a = a;
+    zit->b = b;
+    zit->asize = asize;
+    zit->boffset = boffset;
+    zit->bsize = bsize;
+    return adapter_init(out, zip_iter_fn, &zip_iter_ops);
+}
+
+struct enumerate_iter {
+    iter_t *src;
+    size_t index;
+    size_t voffset;
+    size_t ssize;
+};
+
+ITER__ASSERT_FITS(struct enumerate_iter);
+
+static int enumerate_iter_fn(
+    iter_t *it, void *out, size_t size, size_t skip
+) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it || size == 0)
+        return ITER_EINVAL;
+
+    if (it == out)
+        return ITER_OK;
+
+    struct enumerate_iter *eit = ITER__CAST(it);
+
+    if (size < eit->voffset + eit->ssize)
+        return ITER_EINVAL;
+
+    void *value = out ? PF_OFFSET(out, eit->voffset) : NULL;
+    int status = iter__call(eit->src, value, eit->ssize, skip);
+    if (status)
+        return status;
+
+    eit->index += skip;
+    if (out) {
+        memcpy(out, &eit->index, sizeof(size_t));
+        eit->index++;
+    }
+
+    return ITER_OK;
+}
+
+static void enumerate_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    struct enumerate_iter *eit = ITER__CAST(it);
+    iter__size_hint(eit->src, lower, upper, eit->ssize);
+}
+
+static const struct iter_ops enumerate_iter_ops = {
+    NULL,
+    NULL,
+    NULL,
+    enumerate_size_hint,
+};
+
+iter_t *iter__enumerate(
+    iter_t *out, iter_t *src, size_t voffset, size_t ssize
+) {
+    if (!out || !src || ssize == 0 || voffset < sizeof(size_t))
+        return NULL;
+
+    struct enumerate_iter *eit = ITER__CAST(out);
+    eit->src = src;
+    eit->index = 0;
+    eit->voffset = voffset;
+    eit->ssize = ssize;
+    return adapter_init(out, enumerate_iter_fn, &enumerate_iter_ops);
+}
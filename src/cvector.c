@@ -0,0 +1,201 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <iter/vector.h>
+#include <pf_bitwise.h>
+#include <pf_macro.h>
+#include <string.h>
+
+#ifndef ITER_NO_THREADS
+    #include <sched.h>
+#endif
+
+#undef ITER_API
+#define ITER_API
+#include <iter/cvector.h>
+
+extern allocator_t *libiter_allocator;
+
+#define CVECTOR_FIRST_BYTES 4096
+
+/* Marks a segment that is being allocated by another thread. */
+#define SEGMENT_BUSY ((void *)1)
+
+static inline size_t first_shift(const cvector_t *cv) {
+    return __builtin_ctzl(cv->first);
+}
+
+/* Segment `k` holds `first << k` items, starting at `first * (2^k - 1)`. */
+static inline size_t segment_of(const cvector_t *cv, size_t i) {
+    size_t q = (i >> first_shift(cv)) + 1;
+    return sizeof(size_t) * 8 - 1 - __builtin_clzl(q);
+}
+
+static inline size_t segment_start(const cvector_t *cv, size_t k) {
+    return cv->first * (((size_t)1 << k) - 1);
+}
+
+static inline size_t segment_bytes(const cvector_t *cv, size_t k) {
+    return (cv->first << k) * cv->stride;
+}
+
+static void *segment_get(cvector_t *cv, size_t k) {
+    for (;;) {
+        void *seg = __atomic_load_n(&cv->segments[k], __ATOMIC_ACQUIRE);
+
+        if (seg != NULL && seg != SEGMENT_BUSY)
+            return seg;
+
+        /* another producer is allocating it, wait until it's published. */
+        if (seg == SEGMENT_BUSY) {
+#ifndef ITER_NO_THREADS
+            sched_yield();
+#endif
+            continue;
+        }
+
+        if (__atomic_compare_exchange_n(
+                &cv->segments[k],
+                &seg,
+                SEGMENT_BUSY,
+                0,
+                __ATOMIC_ACQ_REL,
+                __ATOMIC_ACQUIRE
+            )) {
+            /* zeroed, so ranges of pushes that failed read as zeroes. */
+            seg = allocate(cv->allocator, segment_bytes(cv, k));
+            if (seg)
+                memset(seg, 0, segment_bytes(cv, k));
+
+            __atomic_store_n(&cv->segments[k], seg, __ATOMIC_RELEASE);
+            return seg;
+        }
+    }
+}
+
+cvector_t *cvector__create(
+    size_t capacity, allocator_t *allocator, size_t stride
+) {
+    if (stride == 0)
+        return NULL;
+
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    if (capacity == 0)
+        capacity = PF_MAX(CVECTOR_FIRST_BYTES / stride, 1);
+
+    cvector_t *cv = allocate(allocator, sizeof(cvector_t));
+    if (cv) {
+        cv->length = 0;
+        cv->stride = stride;
+        cv->first = pf_pow2ceilsize(capacity);
+        cv->allocator = allocator;
+        memset(cv->segments, 0, sizeof(cv->segments));
+    }
+
+    return cv;
+}
+
+void cvector__destroy(cvector_t *cv) {
+    if (!cv)
+        return;
+
+    for (size_t k = 0; k < CVECTOR_SEGMENTS; k++) {
+        if (cv->segments[k])
+            deallocate(cv->allocator, cv->segments[k], segment_bytes(cv, k));
+    }
+
+    deallocate(cv->allocator, cv, sizeof(cvector_t));
+}
+
+int cvector__push(
+    cvector_t *cv, const void *items, size_t count, size_t *index
+) {
+    if (!cv || !items || count == 0 || count > SIZE_MAX / cv->stride)
+        return ITER_EINVAL;
+
+    size_t i = __atomic_fetch_add(&cv->length, count, __ATOMIC_RELAXED);
+    const unsigned char *src = items;
+    int status = ITER_OK;
+
+    if (index)
+        *index = i;
+
+    while (count > 0) {
+        size_t k = segment_of(cv, i);
+        size_t offset = i - segment_start(cv, k);
+        size_t n = PF_MIN(count, (cv->first << k) - offset);
+        void *seg = segment_get(cv, k);
+
+        if (seg)
+            memcpy(PF_OFFSET(seg, offset * cv->stride), src, n * cv->stride);
+        else
+            status = ITER_ENOMEM;
+
+        src += n * cv->stride;
+        count -= n;
+        i += n;
+    }
+
+    return status;
+}
+
+void *cvector__get(const cvector_t *cv, size_t i) {
+    if (!cv || i >= cvector__length(cv))
+        return NULL;
+
+    size_t k = segment_of(cv, i);
+    void *seg = __atomic_load_n(&cv->segments[k], __ATOMIC_ACQUIRE);
+
+    if (seg == NULL || seg == SEGMENT_BUSY)
+        return NULL;
+
+    return PF_OFFSET(seg, (i - segment_start(cv, k)) * cv->stride);
+}
+
+vector_t *cvector__seal(cvector_t *cv) {
+    if (!cv)
+        return NULL;
+
+    vector_t *out = vector__create(cv->allocator);
+    if (!out)
+        return NULL;
+
+    size_t length = cv->length;
+
+    if (length <= cv->first && cv->segments[0]) {
+        out->items = cv->segments[0];
+        out->capacity = segment_bytes(cv, 0);
+        out->length = length * cv->stride;
+        cv->segments[0] = NULL;
+        cvector__destroy(cv);
+        return out;
+    }
+
+    if (length > 0 && vector__resize(out, length * cv->stride)) {
+        vector__destroy(out);
+        return NULL;
+    }
+
+    for (size_t k = 0; out->length < length * cv->stride; k++) {
+        size_t n = PF_MIN(length - segment_start(cv, k), cv->first << k);
+        void *dst = vector__end(out);
+
+        if (cv->segments[k])
+            memcpy(dst, cv->segments[k], n * cv->stride);
+        else
+            memset(dst, 0, n * cv->stride);
+
+        out->length += n * cv->stride;
+    }
+
+    cvector__destroy(cv);
+    return out;
+}
@@ -0,0 +1,383 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <errno.h>
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <iter/vector.h>
+#include <limits.h>
+#include <pf_macro.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/file.h>
+
+extern allocator_t *libiter_allocator;
+
+struct external;
+
+/* A sorted run of the temporary file, read back through `buffer`. */
+struct run {
+    struct external *ext;
+    off_t offset;
+    off_t end;
+    unsigned char *buffer;
+    size_t capacity;
+    size_t begin;
+    size_t length;
+};
+
+/*
+    `memory` holds the run being sorted and its scratch space, and is later
+    divided between the read buffers of runs. `merged` is either an array
+    iterator over `memory`, if everything fit into a single run, or a merge
+    of `readers`.
+*/
+struct external {
+    allocator_t *allocator;
+    size_t size;
+    size_t left;
+    int fd;
+    int error;
+
+    unsigned char *memory;
+    size_t memory_bytes;
+
+    vector_t runs;
+    iter_t *readers;
+    iter_t **inputs;
+    iter_t merged;
+};
+
+static int write_all(int fd, const void *data, size_t length) {
+    const unsigned char *p = data;
+
+    while (length > 0) {
+        ssize_t written = write(fd, p, length);
+
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return ITER_EIO;
+
+        p += written;
+        length -= (size_t)written;
+    }
+
+    return ITER_OK;
+}
+
+static int run_fill(struct run *run) {
+    size_t size = run->ext->size;
+    off_t left = run->end - run->offset;
+    size_t want = (size_t)PF_MIN((off_t)run->capacity, left);
+
+    run->begin = run->length = 0;
+
+    while (run->length < want) {
+        ssize_t n = pread(
+            run->ext->fd,
+            run->buffer + run->length,
+            want - run->length,
+            run->offset + (off_t)run->length
+        );
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            run->ext->error = ITER_EIO;
+            return ITER_EIO;
+        }
+
+        run->length += (size_t)n;
+    }
+
+    run->offset += (off_t)want;
+    return want >= size ? ITER_OK : ITER_ENODATA;
+}
+
+static int run_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (!it || it == out)
+        return it ? ITER_OK : ITER_EINVAL;
+
+    struct run *run = *(struct run **)ITER__CAST(it);
+
+    for (skip += out ? 1 : 0; skip > 0; skip--) {
+        if (run->begin >= run->length) {
+            int status = run_fill(run);
+            if (status)
+                return status;
+        }
+
+        if (out && skip == 1)
+            memcpy(out, run->buffer + run->begin, size);
+        run->begin += size;
+    }
+
+    return ITER_OK;
+}
+
+static void external_free(iter_t *it, struct external *ext) {
+    allocator_t *allocator = ext->allocator;
+    size_t k = ext->runs.length / sizeof(struct run);
+
+    iter__call(&ext->merged, &ext->merged, ext->size, 0);
+
+    if (ext->fd >= 0)
+        close(ext->fd);
+
+    if (ext->readers) {
+        deallocate(allocator, ext->readers, k * sizeof(iter_t));
+        deallocate(allocator, ext->inputs, k * sizeof(iter_t *));
+    }
+
+    vector__free(&ext->runs);
+    deallocate(allocator, ext->memory, ext->memory_bytes);
+    deallocate(allocator, ext, sizeof(*ext));
+
+    if (it)
+        *(struct external **)ITER__CAST(it) = NULL;
+}
+
+static int external_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it)
+        return ITER_EINVAL;
+
+    struct external *ext = *(struct external **)ITER__CAST(it);
+
+    if (it == out) {
+        if (ext)
+            external_free(it, ext);
+        return ITER_OK;
+    }
+
+    if (!ext)
+        return ITER_ENODATA;
+
+    if (size != ext->size)
+        return ITER_EINVAL;
+
+    int status = iter__call(&ext->merged, out, size, skip);
+
+    /* exhausted readers look like ends of runs to the merge. */
+    if (ext->error)
+        status = ext->error;
+
+    if (status) {
+        external_free(it, ext);
+        return status;
+    }
+
+    size_t taken = skip + (out ? 1 : 0);
+    ext->left -= PF_MIN(taken, ext->left);
+    return ITER_OK;
+}
+
+static void external_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    (void)size;
+
+    struct external *ext = *(struct external **)ITER__CAST(it);
+    *lower = *upper = ext ? ext->left : 0;
+}
+
+static const struct iter_ops external_iter_ops = {
+    NULL,
+    NULL,
+    NULL,
+    external_size_hint,
+};
+
+static int open_temp(const char *tmpdir) {
+    char path[PATH_MAX];
+
+    if (!tmpdir)
+        tmpdir = getenv("TMPDIR");
+    if (!tmpdir || !*tmpdir)
+        tmpdir = "/tmp";
+
+    int length = snprintf(path, sizeof(path), "%s/libiter-XXXXXX", tmpdir);
+    if (length < 0 || (size_t)length >= sizeof(path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    int fd = mkstemp(path);
+    if (fd >= 0)
+        unlink(path);
+
+    return fd;
+}
+
+/* Sorts `count` items at the start of `memory`, using the rest as scratch. */
+static void sort_run(
+    struct external *ext, iter_compare_fn *cmp, size_t count
+) {
+    size_t bytes = count * ext->size;
+    vector_t run;
+
+    vector__init(&run, ext->allocator);
+    run.items = ext->memory;
+    run.length = run.capacity = bytes;
+
+    vector__sort_with_buffer(
+        &run, cmp, ext->memory + bytes, ext->memory_bytes - bytes, ext->size
+    );
+}
+
+static int spill_run(struct external *ext, size_t count, const char *tmpdir) {
+    off_t offset = 0;
+    size_t k = ext->runs.length / sizeof(struct run);
+
+    if (k > 0)
+        offset = ((struct run *)ext->runs.items)[k - 1].end;
+    else if ((ext->fd = open_temp(tmpdir)) < 0)
+        return ITER_EIO;
+
+    struct run run = { 0 };
+    run.ext = ext;
+    run.offset = offset;
+    run.end = offset + (off_t)(count * ext->size);
+
+    if (vector__push(&ext->runs, &run, sizeof(run)))
+        return ITER_ENOMEM;
+
+    return write_all(ext->fd, ext->memory, count * ext->size);
+}
+
+/* Divides `memory` between the runs and merges them. */
+static int merge_runs(struct external *ext, iter_compare_fn *cmp) {
+    size_t k = ext->runs.length / sizeof(struct run);
+    size_t share = ext->memory_bytes / k / ext->size * ext->size;
+    struct run *runs = ext->runs.items;
+
+    if (share == 0) {
+        unsigned char *memory = allocate(ext->allocator, k * ext->size);
+        if (!memory)
+            return ITER_ENOMEM;
+
+        deallocate(ext->allocator, ext->memory, ext->memory_bytes);
+        ext->memory = memory;
+        ext->memory_bytes = k * ext->size;
+        share = ext->size;
+    }
+
+    ext->readers = allocate(ext->allocator, k * sizeof(iter_t));
+    ext->inputs = allocate(ext->allocator, k * sizeof(iter_t *));
+
+    if (!ext->readers || !ext->inputs) {
+        if (ext->readers)
+            deallocate(ext->allocator, ext->readers, k * sizeof(iter_t));
+        if (ext->inputs)
+            deallocate(ext->allocator, ext->inputs, k * sizeof(iter_t *));
+        ext->readers = NULL;
+        return ITER_ENOMEM;
+    }
+
+    for (size_t i = 0; i < k; i++) {
+        runs[i].ext = ext;
+        runs[i].buffer = ext->memory + i * share;
+        runs[i].capacity = share;
+
+        ext->readers[i].call = &run_iter_fn;
+        ext->readers[i].ops = NULL;
+        *(struct run **)ITER__CAST(&ext->readers[i]) = &runs[i];
+        ext->inputs[i] = &ext->readers[i];
+    }
+
+    iter_t *merged = iter__merge(
+        &ext->merged, ext->inputs, k, ext->size, cmp, ext->allocator
+    );
+
+    if (!merged)
+        return ITER_ENOMEM;
+
+    return ext->error;
+}
+
+iter_t *iter__sort_external(
+    iter_t *out,
+    iter_t *src,
+    iter_compare_fn *cmp,
+    size_t mem_budget,
+    const char *tmpdir,
+    allocator_t *allocator,
+    size_t size
+) {
+    if (!out || !src || !cmp || size == 0 || mem_budget / size < 2)
+        return NULL;
+
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    struct external *ext = allocate(allocator, sizeof(*ext));
+    if (!ext)
+        return NULL;
+
+    /* two thirds of the budget hold the run, the rest is scratch space. */
+    size_t capacity = mem_budget / size;
+    size_t run_items = capacity * 2 / 3;
+
+    memset(ext, 0, sizeof(*ext));
+    ext->allocator = allocator;
+    ext->size = size;
+    ext->fd = -1;
+    ext->memory_bytes = capacity * size;
+    ext->memory = allocate(allocator, ext->memory_bytes);
+    vector__init(&ext->runs, allocator);
+
+    if (!ext->memory) {
+        deallocate(allocator, ext, sizeof(*ext));
+        return NULL;
+    }
+
+    int status = ITER_OK;
+
+    for (;;) {
+        size_t count = iter__next_n(src, ext->memory, run_items, size);
+        int last = count < run_items;
+
+        if (count > 0)
+            sort_run(ext, cmp, count);
+
+        ext->left += count;
+
+        if (last && ext->fd < 0) {
+            iter__from_array(&ext->merged, ext->memory, count * size);
+            break;
+        }
+
+        if (count > 0 && (status = spill_run(ext, count, tmpdir)))
+            break;
+
+        if (last) {
+            status = merge_runs(ext, cmp);
+            break;
+        }
+    }
+
+    if (status) {
+        int error = errno;
+        external_free(NULL, ext);
+        errno = error;
+        return NULL;
+    }
+
+    out->call = &external_iter_fn;
+    out->ops = &external_iter_ops;
+    *(struct external **)ITER__CAST(out) = ext;
+    return out;
+}
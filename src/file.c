@@ -0,0 +1,279 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <fcntl.h>
+#include <iter/error.h>
+#include <pf_macro.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/file.h>
+
+#if !defined(ITER_NO_SIMD) && defined(__SSE2__)
+    #define FILE_SSE2
+    #include <emmintrin.h>
+#endif
+
+extern allocator_t *libiter_allocator;
+
+/* Mappings are shared by iterators split from each other. */
+struct mapping {
+    allocator_t *allocator;
+    size_t refs;
+    void *base;
+    size_t length;
+};
+
+/* `record_size` is 0 for iterators over lines. */
+struct file_iter {
+    struct mapping *map;
+    const char *current;
+    const char *end;
+    size_t record_size;
+};
+
+ITER__ASSERT_FITS(struct file_iter);
+
+static void mapping_release(struct mapping *map) {
+    if (map && __atomic_sub_fetch(&map->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        munmap(map->base, map->length);
+        deallocate(map->allocator, map, sizeof(*map));
+    }
+}
+
+/* Returns the first newline in `[p, end)`, or `end` if there is none. */
+static const char *find_newline(const char *p, const char *end) {
+#ifdef FILE_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    for (; end - p >= 16; p += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(chunk, newline)
+        );
+
+        if (mask)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+
+    const char *found = memchr(p, '\n', (size_t)(end - p));
+    return found ? found : end;
+}
+
+static int next_view(struct file_iter *fit, iter_view_t *view) {
+    if (fit->current >= fit->end)
+        return 0;
+
+    size_t left = (size_t)(fit->end - fit->current);
+    view->data = fit->current;
+
+    if (fit->record_size > 0) {
+        view->length = PF_MIN(fit->record_size, left);
+        fit->current += view->length;
+    } else {
+        const char *newline = find_newline(fit->current, fit->end);
+        view->length = (size_t)(newline - fit->current);
+        fit->current = newline < fit->end ? newline + 1 : fit->end;
+    }
+
+    return 1;
+}
+
+static void file_iter_release(struct file_iter *fit) {
+    mapping_release(fit->map);
+    fit->map = NULL;
+    fit->current = fit->end = NULL;
+}
+
+static int file_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it)
+        return ITER_EINVAL;
+
+    struct file_iter *fit = ITER__CAST(it);
+
+    if (it == out) {
+        file_iter_release(fit);
+        return ITER_OK;
+    }
+
+    if (!fit->map)
+        return ITER_ENODATA;
+
+    if (size != sizeof(iter_view_t))
+        return ITER_EINVAL;
+
+    if (fit->record_size > 0 && skip > 0) {
+        size_t left = (size_t)(fit->end - fit->current);
+        size_t records = (left + fit->record_size - 1) / fit->record_size;
+
+        fit->current += PF_MIN(skip, records) * fit->record_size;
+        fit->current = PF_MIN(fit->current, fit->end);
+        skip = skip > records ? 1 : 0;
+    }
+
+    iter_view_t view;
+    /* the mapping outlives exhaustion, since views point into it. */
+    for (skip += out ? 1 : 0; skip > 0; skip--) {
+        if (!next_view(fit, &view))
+            return ITER_ENODATA;
+    }
+
+    if (out)
+        memcpy(out, &view, sizeof(view));
+    return ITER_OK;
+}
+
+/* Returns the start of the first line after the middle of `[begin, end)`. */
+static const char *split_lines(const char *begin, const char *end) {
+    const char *mid = begin + (end - begin) / 2;
+    const char *newline = find_newline(mid, end);
+
+    if (newline + 1 < end)
+        return newline + 1;
+
+    for (newline = mid; newline > begin; newline--)
+        if (newline[-1] == '\n')
+            return newline;
+
+    return NULL;
+}
+
+static int file_iter_split(iter_t *it, iter_t *out, size_t size) {
+    struct file_iter *fit = ITER__CAST(it);
+    const char *mid = NULL;
+
+    if (size != sizeof(iter_view_t))
+        return ITER_EINVAL;
+
+    if (!fit->map || fit->current >= fit->end)
+        return ITER_ENODATA;
+
+    if (fit->record_size > 0) {
+        size_t left = (size_t)(fit->end - fit->current);
+        size_t records = (left + fit->record_size - 1) / fit->record_size;
+
+        if (records >= 2)
+            mid = fit->current + records / 2 * fit->record_size;
+    } else {
+        mid = split_lines(fit->current, fit->end);
+    }
+
+    if (!mid)
+        return ITER_ENODATA;
+
+    __atomic_add_fetch(&fit->map->refs, 1, __ATOMIC_RELAXED);
+
+    struct file_iter *half = ITER__CAST(out);
+    *out = *it;
+    half->current = mid;
+    fit->end = mid;
+    return ITER_OK;
+}
+
+/* Every line takes at least one byte, so bytes bound the number of lines. */
+static void file_iter_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    (void)size;
+
+    struct file_iter *fit = ITER__CAST(it);
+    size_t left = fit->current < fit->end
+                    ? (size_t)(fit->end - fit->current)
+                    : 0;
+
+    if (fit->record_size > 0) {
+        *lower = *upper = (left + fit->record_size - 1) / fit->record_size;
+    } else {
+        *lower = left > 0 ? 1 : 0;
+        *upper = left;
+    }
+}
+
+static const struct iter_ops file_iter_ops = {
+    NULL,
+    NULL,
+    file_iter_split,
+    file_iter_size_hint,
+};
+
+static iter_t *file_open(
+    iter_t *out, const char *path, size_t record_size, allocator_t *allocator
+) {
+    if (!out || !path)
+        return NULL;
+
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) || (uintmax_t)st.st_size > SIZE_MAX) {
+        close(fd);
+        return NULL;
+    }
+
+    struct file_iter *fit = ITER__CAST(out);
+    size_t length = (size_t)st.st_size;
+    struct mapping *map = NULL;
+    void *base = NULL;
+
+    /* empty files can't be mapped, their iterators start exhausted. */
+    if (length > 0) {
+        base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        map = base != MAP_FAILED ? allocate(allocator, sizeof(*map)) : NULL;
+
+        if (!map) {
+            if (base != MAP_FAILED)
+                munmap(base, length);
+            close(fd);
+            return NULL;
+        }
+
+        madvise(base, length, MADV_SEQUENTIAL);
+        map->allocator = allocator;
+        map->refs = 1;
+        map->base = base;
+        map->length = length;
+    }
+
+    close(fd);
+
+    out->call = &file_iter_fn;
+    out->ops = &file_iter_ops;
+    fit->map = map;
+    fit->current = base;
+    fit->end = map ? (const char *)base + length : NULL;
+    fit->record_size = record_size;
+    return out;
+}
+
+iter_t *iter__from_file_lines(
+    iter_t *out, const char *path, allocator_t *allocator
+) {
+    return file_open(out, path, 0, allocator);
+}
+
+iter_t *iter__from_file_records(
+    iter_t *out, const char *path, size_t record_size, allocator_t *allocator
+) {
+    return record_size > 0 ? file_open(out, path, record_size, allocator)
+                           : NULL;
+}
@@ -0,0 +1,277 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <pf_macro.h>
+#include <stdint.h>
+#include <string.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/gapvec.h>
+
+extern allocator_t *libiter_allocator;
+
+struct gapvec_iter {
+    const gapvec_t *gv;
+    size_t index;
+};
+
+ITER__ASSERT_FITS(struct gapvec_iter);
+
+static inline unsigned char *bytes(const gapvec_t *gv) {
+    return gv->items;
+}
+
+gapvec_t *gapvec__create(allocator_t *allocator) {
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    gapvec_t *gv = allocate(allocator, sizeof(gapvec_t));
+    if (gv) {
+        gv->items = NULL;
+        gv->gap = gv->gap_length = gv->capacity = 0;
+        gv->allocator = allocator;
+    }
+
+    return gv;
+}
+
+void gapvec__destroy(gapvec_t *gv) {
+    if (gv) {
+        if (gv->items)
+            deallocate(gv->allocator, gv->items, gv->capacity);
+
+        deallocate(gv->allocator, gv, sizeof(gapvec_t));
+    }
+}
+
+size_t gapvec__spans(
+    const gapvec_t *gv,
+    void **first,
+    size_t *first_len,
+    void **second,
+    size_t *second_len,
+    size_t size
+) {
+    if (!gv || size == 0)
+        return 0;
+
+    size_t tail = gv->gap + gv->gap_length;
+
+    if (first)
+        *first = gv->items;
+    if (first_len)
+        *first_len = gv->gap / size;
+    if (second)
+        *second = gv->items ? bytes(gv) + tail : NULL;
+    if (second_len)
+        *second_len = (gv->capacity - tail) / size;
+
+    return gapvec__length(gv) / size;
+}
+
+int gapvec__move_gap(gapvec_t *gv, size_t i) {
+    if (!gv || i > gapvec__length(gv))
+        return ITER_EINVAL;
+
+    unsigned char *items = bytes(gv);
+
+    if (i < gv->gap)
+        memmove(items + i + gv->gap_length, items + i, gv->gap - i);
+    else if (i > gv->gap)
+        memmove(
+            items + gv->gap,
+            items + gv->gap + gv->gap_length,
+            i - gv->gap
+        );
+
+    gv->gap = i;
+    return ITER_OK;
+}
+
+int gapvec__reserve(gapvec_t *gv, size_t size, size_t stride) {
+    if (!gv || stride == 0 || size > SIZE_MAX - gv->capacity)
+        return ITER_EINVAL;
+
+    if (size <= gv->gap_length)
+        return ITER_OK;
+
+    size_t required = gv->capacity + size - gv->gap_length;
+    size_t capacity = required;
+
+    if (required <= SIZE_MAX / 3 * 2)
+        capacity = required + required / 2;
+
+    /* the items after the gap must stay aligned to `stride`. */
+    capacity -= capacity % stride;
+    if (capacity < required)
+        capacity = required;
+
+    void *items = reallocate(
+        gv->allocator, gv->items, gv->capacity, capacity
+    );
+
+    if (!items)
+        return ITER_ENOMEM;
+
+    size_t tail = gv->gap + gv->gap_length;
+    size_t grown = capacity - gv->capacity;
+
+    memmove(
+        PF_OFFSET(items, tail + grown),
+        PF_OFFSET(items, tail),
+        gv->capacity - tail
+    );
+
+    gv->items = items;
+    gv->gap_length += grown;
+    gv->capacity = capacity;
+    return ITER_OK;
+}
+
+int gapvec__insert(
+    gapvec_t *gv, const void *items, size_t i, size_t size, size_t stride
+) {
+    if (!gv || !items || size == 0 || i > gapvec__length(gv))
+        return ITER_EINVAL;
+
+    int status = gapvec__reserve(gv, size, stride);
+    if (status)
+        return status;
+
+    gapvec__move_gap(gv, i);
+    memcpy(bytes(gv) + gv->gap, items, size);
+    gv->gap += size;
+    gv->gap_length -= size;
+    return ITER_OK;
+}
+
+int gapvec__remove(gapvec_t *gv, size_t i, size_t size) {
+    if (!gv || size == 0 || size > gapvec__length(gv)
+        || i > gapvec__length(gv) - size)
+        return ITER_EINVAL;
+
+    gapvec__move_gap(gv, i);
+    gv->gap_length += size;
+    return ITER_OK;
+}
+
+void *gapvec__flatten(gapvec_t *gv) {
+    if (!gv || gapvec__length(gv) == 0)
+        return NULL;
+
+    gapvec__move_gap(gv, gapvec__length(gv));
+    return gv->items;
+}
+
+static int gapvec_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it || size == 0)
+        return ITER_EINVAL;
+
+    if (it == out)
+        return ITER_OK;
+
+    struct gapvec_iter *git = ITER__CAST(it);
+    size_t length = gapvec__length(git->gv);
+    size_t left = (length - PF_MIN(git->index, length)) / size;
+
+    if (skip) {
+        git->index = skip > left ? length : git->index + skip * size;
+
+        if (git->index >= length)
+            return ITER_ENODATA;
+    }
+
+    if (out) {
+        if (git->index >= length)
+            return ITER_ENODATA;
+
+        memcpy(out, gapvec__get(git->gv, git->index), size);
+        git->index += size;
+    }
+
+    return ITER_OK;
+}
+
+static int gapvec_iter_next_span(
+    iter_t *it, const void **items, size_t *count, uint64_t *mask, size_t size
+) {
+    struct gapvec_iter *git = ITER__CAST(it);
+    const gapvec_t *gv = git->gv;
+    size_t length = gapvec__length(gv);
+
+    if (git->index + size > length)
+        return ITER_ENODATA;
+
+    /* the items before the gap end at the gap, the rest at the end. */
+    size_t end = git->index < gv->gap ? gv->gap : length;
+
+    *items = gapvec__get(gv, git->index);
+    *count = (end - git->index) / size;
+    if (mask)
+        *mask = UINT64_MAX;
+
+    git->index = end;
+    return ITER_OK;
+}
+
+static size_t gapvec_iter_next_n(
+    iter_t *it, void *out, size_t max, size_t size
+) {
+    const void *items;
+    size_t count, n = 0;
+
+    while (n < max && !gapvec_iter_next_span(it, &items, &count, NULL, size)) {
+        struct gapvec_iter *git = ITER__CAST(it);
+
+        /* give back the part of the span that doesn't fit into `out`. */
+        if (count > max - n) {
+            git->index -= (count - (max - n)) * size;
+            count = max - n;
+        }
+
+        memcpy(PF_OFFSET(out, n * size), items, count * size);
+        n += count;
+    }
+
+    return n;
+}
+
+static void gapvec_iter_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    struct gapvec_iter *git = ITER__CAST(it);
+    size_t length = gapvec__length(git->gv);
+
+    *lower = *upper = (length - PF_MIN(git->index, length)) / size;
+}
+
+static const struct iter_ops gapvec_iter_ops = {
+    gapvec_iter_next_n,
+    gapvec_iter_next_span,
+    NULL,
+    gapvec_iter_size_hint,
+};
+
+iter_t *gapvec__iter(const gapvec_t *gv, iter_t *out) {
+    if (!gv || !out)
+        return NULL;
+
+    struct gapvec_iter *git = ITER__CAST(out);
+    git->gv = gv;
+    git->index = 0;
+    out->call = gapvec_iter_fn;
+    out->ops = &gapvec_iter_ops;
+
+    return out;
+}
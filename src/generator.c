@@ -0,0 +1,69 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <iter/error.h>
+#include <iter/iter.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/generator.h>
+
+/* Stored in the buffer of the `iter_t`, so generators never allocate. */
+struct generator {
+    iter_gen_fn *fn;
+    void *state;
+    iter_gen_t gen;
+};
+
+ITER__ASSERT_FITS(struct generator);
+
+static int generator_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (!it)
+        return ITER_EINVAL;
+
+    struct generator *g = ITER__CAST(it);
+
+    if (it == out) {
+        g->gen.line = ITER__GEN_DONE;
+        return ITER_OK;
+    }
+
+    if (g->gen.line == ITER__GEN_DONE)
+        return ITER_ENODATA;
+
+    if (size != g->gen.size)
+        return ITER_EINVAL;
+
+    for (skip += out ? 1 : 0; skip > 0; skip--) {
+        int status = g->fn(&g->gen, g->state, skip == 1 ? out : NULL);
+
+        if (status) {
+            g->gen.line = ITER__GEN_DONE;
+            return status;
+        }
+    }
+
+    return ITER_OK;
+}
+
+iter_t *iter__generator(
+    iter_t *out, iter_gen_fn *fn, void *state, size_t size
+) {
+    if (!out || !fn || size == 0)
+        return NULL;
+
+    struct generator *g = ITER__CAST(out);
+
+    g->fn = fn;
+    g->state = state;
+    g->gen.line = 0;
+    g->gen.size = size;
+
+    out->call = &generator_iter_fn;
+    out->ops = NULL;
+    return out;
+}
@@ -0,0 +1,299 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <iter/hashmap.h>
+#include <iter/iter.h>
+#include <pf_macro.h>
+#include <string.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/group.h>
+
+extern allocator_t *libiter_allocator;
+
+/*
+    Values of `map` are whole pairs, so that `entries` can return them
+    without looking up their keys. `status` is the status of `src` once it
+    stops returning items. `pending` is set when `item` was read but not
+    aggregated yet, or, for sorted inputs, while `pair` holds a group.
+    Otherwise `pair` is where skipped entries are read to, so the end of a
+    batch is noticed while skipping too.
+*/
+struct group {
+    allocator_t *allocator;
+    size_t bytes;
+    iter_t *src;
+    iter_key_fn *key_fn;
+    iter_init_fn *init;
+    iter_accumulate_fn *accumulate;
+    void *user;
+    size_t ssize, ksize, aoffset, psize;
+    size_t max_groups;
+    int status;
+    int pending;
+    int yielding;
+    int sorted;
+    hashmap_t map;
+    iter_t entries;
+    unsigned char *item;
+    unsigned char *key;
+    unsigned char *pair;
+};
+
+static void group_free(iter_t *it, struct group *g) {
+    hashmap__free(&g->map);
+    deallocate(g->allocator, g, g->bytes);
+    *(struct group **)ITER__CAST(it) = NULL;
+}
+
+static int group_read(struct group *g) {
+    g->status = iter__call(g->src, g->item, g->ssize, 0);
+
+    if (!g->status) {
+        memset(g->key, 0, g->ksize);
+        g->key_fn(g->key, g->item, g->user);
+    }
+
+    return g->status;
+}
+
+static void group_start(struct group *g, unsigned char *pair) {
+    memcpy(pair, g->key, g->ksize);
+    g->init(pair + g->aoffset, g->key, g->user);
+}
+
+/* Aggregates items of `src` until it stops or `map` has to be flushed. */
+static int group_fill(struct group *g) {
+    for (;;) {
+        if (!g->pending && group_read(g))
+            return g->status == ITER_ENODATA ? ITER_OK : g->status;
+
+        unsigned char *pair;
+        int inserted = 0;
+
+        g->pending = 0;
+
+        if (g->max_groups > 0 && g->map.count >= g->max_groups) {
+            pair = hashmap__get(&g->map, g->key);
+
+            if (!pair) {
+                g->pending = 1;
+                return ITER_OK;
+            }
+        } else if (!(pair = hashmap__upsert(&g->map, g->key, &inserted))) {
+            return ITER_ENOMEM;
+        }
+
+        if (inserted)
+            group_start(g, pair);
+        g->accumulate(pair + g->aoffset, g->item, g->user);
+    }
+}
+
+static int group_next(struct group *g, void *out) {
+    for (;;) {
+        if (g->yielding) {
+            void *dst = out ? out : g->pair;
+
+            if (!iter__call(&g->entries, dst, g->psize, 0))
+                return ITER_OK;
+
+            g->yielding = 0;
+            hashmap__clear(&g->map);
+        }
+
+        if (g->status && !g->pending)
+            return g->status;
+
+        int status = group_fill(g);
+        if (status)
+            return status;
+
+        if (g->map.count == 0)
+            return ITER_ENODATA;
+
+        hashmap__iter(&g->map, &g->entries);
+        g->yielding = 1;
+    }
+}
+
+static int group_sorted_next(struct group *g, void *out) {
+    for (;;) {
+        if (g->status) {
+            if (g->status != ITER_ENODATA || !g->pending)
+                return g->status;
+
+            /* the last group ends with `src`. */
+            g->pending = 0;
+            break;
+        }
+
+        if (group_read(g))
+            continue;
+
+        if (g->pending && 0 == memcmp(g->key, g->pair, g->ksize)) {
+            g->accumulate(g->pair + g->aoffset, g->item, g->user);
+            continue;
+        }
+
+        int flushed = g->pending;
+        if (flushed && out)
+            memcpy(out, g->pair, g->psize);
+
+        group_start(g, g->pair);
+        g->accumulate(g->pair + g->aoffset, g->item, g->user);
+        g->pending = 1;
+
+        if (flushed)
+            return ITER_OK;
+    }
+
+    if (out)
+        memcpy(out, g->pair, g->psize);
+    return ITER_OK;
+}
+
+static int group_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (!it)
+        return ITER_EINVAL;
+
+    struct group *g = *(struct group **)ITER__CAST(it);
+
+    if (it == out) {
+        if (g)
+            group_free(it, g);
+        return ITER_OK;
+    }
+
+    if (!g)
+        return ITER_ENODATA;
+
+    if (size != g->psize)
+        return ITER_EINVAL;
+
+    for (skip += out ? 1 : 0; skip > 0; skip--) {
+        void *dst = skip == 1 ? out : NULL;
+        int status = g->sorted ? group_sorted_next(g, dst) : group_next(g, dst);
+
+        if (status) {
+            group_free(it, g);
+            return status;
+        }
+    }
+
+    return ITER_OK;
+}
+
+static iter_t *group_create(
+    iter_t *out,
+    const struct group *init,
+    int sorted,
+    allocator_t *allocator
+) {
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    size_t align = alignof(max_align_t);
+    size_t koffset = PF_ALIGN_UP(sizeof(struct group), align);
+    size_t poffset = koffset + PF_ALIGN_UP(init->ksize, align);
+    size_t ioffset = poffset + PF_ALIGN_UP(init->psize, align);
+    size_t bytes = ioffset + init->ssize;
+
+    struct group *g = allocate(allocator, bytes);
+    if (!g)
+        return NULL;
+
+    *g = *init;
+    g->allocator = allocator;
+    g->bytes = bytes;
+    g->key = PF_OFFSET(g, koffset);
+    g->sorted = sorted;
+    g->pair = PF_OFFSET(g, poffset);
+    g->item = PF_OFFSET(g, ioffset);
+
+    if (!sorted) {
+        const struct hashmap_layout layout = {
+            g->ksize, 1, g->psize, align,
+        };
+
+        hashmap__init(&g->map, allocator, &layout);
+    }
+
+    out->call = &group_iter_fn;
+    out->ops = NULL;
+    *(struct group **)ITER__CAST(out) = g;
+    return out;
+}
+
+iter_t *iter__group_aggregate(
+    iter_t *out,
+    iter_t *src,
+    iter_key_fn *key,
+    iter_init_fn *init,
+    iter_accumulate_fn *accumulate,
+    void *user,
+    size_t max_groups,
+    allocator_t *allocator,
+    size_t ssize,
+    size_t ksize,
+    size_t aoffset,
+    size_t psize
+) {
+    if (!out || !src || !key || !init || !accumulate || ssize == 0
+        || ksize == 0 || aoffset < ksize || psize <= aoffset)
+        return NULL;
+
+    struct group g = {
+        .src = src,
+        .key_fn = key,
+        .init = init,
+        .accumulate = accumulate,
+        .user = user,
+        .ssize = ssize,
+        .ksize = ksize,
+        .aoffset = aoffset,
+        .psize = psize,
+        .max_groups = max_groups,
+    };
+
+    return group_create(out, &g, 0, allocator);
+}
+
+iter_t *iter__group_aggregate_sorted(
+    iter_t *out,
+    iter_t *src,
+    iter_key_fn *key,
+    iter_init_fn *init,
+    iter_accumulate_fn *accumulate,
+    void *user,
+    allocator_t *allocator,
+    size_t ssize,
+    size_t ksize,
+    size_t aoffset,
+    size_t psize
+) {
+    if (!out || !src || !key || !init || !accumulate || ssize == 0
+        || ksize == 0 || aoffset < ksize || psize <= aoffset)
+        return NULL;
+
+    struct group g = {
+        .src = src,
+        .key_fn = key,
+        .init = init,
+        .accumulate = accumulate,
+        .user = user,
+        .ssize = ssize,
+        .ksize = ksize,
+        .aoffset = aoffset,
+        .psize = psize,
+    };
+
+    return group_create(out, &g, 1, allocator);
+}
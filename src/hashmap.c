@@ -224,8 +224,9 @@ hashmap_t *hashmap__from_arrays(
 
 void hashmap__free(hashmap_t *map) {
     if (map) {
-        size_t buckets = (1 << map->capacityLog2) / META_SIZE;
-        deallocate(map->allocator, map->buffer, buckets * map->bucketSize);
+        size_t buckets = hashmap__capacity(map) / META_SIZE;
+        if (map->buffer)
+            deallocate(map->allocator, map->buffer, buckets * map->bucketSize);
     }
 }
 
@@ -249,15 +250,15 @@ int grow_empty(hashmap_t *map, size_t capacity) {
     void *buffer = reallocate(
         map->allocator,
         map->buffer,
-        sizeof(union hashmeta) * hashmap__capacity(map) / META_SIZE,
-        sizeof(union hashmeta) * capacity / META_SIZE
+        map->bucketSize * hashmap__capacity(map) / META_SIZE,
+        map->bucketSize * capacity / META_SIZE
     );
 
     if (!buffer)
         return ITER_ENOMEM;
 
     map->buffer = buffer;
-    map->capacityLog2 = sizeof(size_t) * 8 - __builtin_clzl(capacity);
+    map->capacityLog2 = sizeof(size_t) * 8 - 1 - __builtin_clzl(capacity);
     hashmap__clear(map);
     return ITER_OK;
 }
@@ -267,7 +268,7 @@ int grow_not_empty(hashmap_t *map, size_t capacity) {
     tmp.buffer = NULL;
     tmp.count = 0;
 
-    if (!grow_empty(&tmp, capacity))
+    if (grow_empty(&tmp, capacity))
         return ITER_ENOMEM;
 
     for (size_t b = 0; b < bucket_count(map); b++) {
@@ -296,8 +297,8 @@ int hashmap__reserve(hashmap_t *map, size_t count) {
     if (map->count + count <= capacity * HASHMAP_THRESHOLD)
         return ITER_OK;
 
-    size_t required = hashmap__capacity(map);
-    capacity = MAX(round_pow2(required) * 2, HASHMAP_MIN);
+    size_t required = (map->count + count) / HASHMAP_THRESHOLD + 1;
+    capacity = MAX(round_pow2(required), MAX(capacity * 2, HASHMAP_MIN));
 
     if (map->count == 0)
         return grow_empty(map, capacity);
@@ -399,6 +400,39 @@ int hashmap__insert(hashmap_t *map, const void *key, const void *value) {
     }
 }
 
+void *hashmap__upsert(hashmap_t *map, const void *key, int *inserted) {
+    if (!map || !key || hashmap__reserve(map, 1))
+        return NULL;
+
+    hash_t hash = get_hash(map, key);
+    uint8_t i, part = meta_part(hash);
+    size_t b, mask = get_mask(map);
+
+    if (inserted)
+        *inserted = 0;
+
+    BUCKET_EACH(hash, mask, b) {
+        union hashmeta *meta = get_meta(map, b);
+        uint64_t matches = meta_match(meta, part);
+
+        BITSET_EACH(matches, i) {
+            if (0 == compare_key(map, key, get_key(map, meta, i)))
+                return get_value(map, meta, i);
+        }
+
+        matches = meta_match(meta, META_EMPTY);
+        BITSET_EACH(matches, i) {
+            map->count++;
+            meta->parts[i] = part;
+            memcpy(get_key(map, meta, i), key, map->ksize);
+
+            if (inserted)
+                *inserted = 1;
+            return get_value(map, meta, i);
+        }
+    }
+}
+
 int hashmap__remove(hashmap_t *map, const void *key) {
     if (!map || !key)
         return ITER_EINVAL;
@@ -518,15 +552,22 @@ int hashmap__filter(hashmap_t *map, hashmap_each_fn *filter, void *user) {
     return ITER_OK;
 }
 
+/* iterators stop at `end`, which is moved back when they are split. */
 struct hashmap_iter {
     const hashmap_t *map;
     const union hashmeta *bucket;
+    const union hashmeta *end;
     size_t index;
 };
 
+ITER__ASSERT_FITS(struct hashmap_iter);
+
 static int hashmap_iter_ref_fn(
     iter_t *it, void *out, size_t size, size_t skip
 ) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
     if (!it || it == out || size != sizeof(void *))
         return ITER_EINVAL;
 
@@ -534,7 +575,7 @@ static int hashmap_iter_ref_fn(
 
     const hashmap_t *map = hit->map;
     const union hashmeta *bucket = hit->bucket;
-    const union hashmeta *end = get_meta(map, bucket_count(map));
+    const union hashmeta *end = hit->end;
     size_t i = hit->index;
 
     if (out)
@@ -567,6 +608,9 @@ static int hashmap_iter_ref_fn(
 }
 
 static int hashmap_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
     if (!it || it == out)
         return ITER_EINVAL;
 
@@ -584,6 +628,171 @@ static int hashmap_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
     return fail;
 }
 
+static inline uint64_t meta_used(const union hashmeta *meta) {
+    union hashmeta *m = (union hashmeta *)meta;
+    uint64_t unused = meta_match(m, META_EMPTY) | meta_match(m, META_TOMB);
+    return ~unused & (~(uint64_t)0 >> (64 - META_SIZE));
+}
+
+/*
+    Values of a bucket are stored sequentially, so runs of occupied slots
+    found in its meta are copied with a single `memcpy`.
+*/
+static size_t hashmap_next_n(iter_t *it, void *out, size_t max, int ref) {
+    struct hashmap_iter *hit = ITER__CAST(it);
+
+    const hashmap_t *map = hit->map;
+    const union hashmeta *bucket = hit->bucket;
+    const union hashmeta *end = hit->end;
+    size_t i = hit->index, n = 0;
+
+    while (bucket < end && n < max) {
+        uint64_t used = meta_used(bucket) & (~(uint64_t)0 << i);
+
+        while (used && n < max) {
+            size_t first = (size_t)__builtin_ctzll(used);
+            size_t run = (size_t)__builtin_ctzll(~(used >> first));
+            run = MIN(run, max - n);
+
+            const uint8_t *src = get_value(map, bucket, (uint8_t)first);
+
+            if (ref) {
+                for (size_t j = 0; j < run; j++)
+                    ((const void **)out)[n + j] = src + j * map->vsize;
+            } else {
+                memcpy(PF_OFFSET(out, n * map->vsize), src, run * map->vsize);
+            }
+
+            n += run;
+            i = first + run;
+            used = i < 64 ? used & (~(uint64_t)0 << i) : 0;
+        }
+
+        if (used)
+            break;
+
+        bucket = PF_OFFSET(bucket, map->bucketSize);
+        i = 0;
+    }
+
+    hit->bucket = bucket;
+    hit->index = i;
+    return n;
+}
+
+static size_t hashmap_iter_next_n(
+    iter_t *it, void *out, size_t max, size_t size
+) {
+    struct hashmap_iter *hit = ITER__CAST(it);
+    return size == hit->map->vsize ? hashmap_next_n(it, out, max, 0) : 0;
+}
+
+static size_t hashmap_iter_ref_next_n(
+    iter_t *it, void *out, size_t max, size_t size
+) {
+    return size == sizeof(void *) ? hashmap_next_n(it, out, max, 1) : 0;
+}
+
+static int hashmap_iter_next_span(
+    iter_t *it, const void **items, size_t *count, uint64_t *mask, size_t size
+) {
+    struct hashmap_iter *hit = ITER__CAST(it);
+
+    const hashmap_t *map = hit->map;
+    const union hashmeta *bucket = hit->bucket;
+    const union hashmeta *end = hit->end;
+    size_t i = hit->index;
+
+    if (size != map->vsize)
+        return ITER_EINVAL;
+
+    for (; bucket < end; bucket = PF_OFFSET(bucket, map->bucketSize), i = 0) {
+        uint64_t used = i < META_SIZE ? meta_used(bucket) >> i : 0;
+        size_t first = 0, run;
+
+        if (!used)
+            continue;
+
+        if (mask) {
+            run = 64 - (size_t)__builtin_clzll(used);
+            *mask = used;
+        } else {
+            first = (size_t)__builtin_ctzll(used);
+            run = (size_t)__builtin_ctzll(~(used >> first));
+        }
+
+        *items = get_value(map, bucket, (uint8_t)(i + first));
+        *count = run;
+        hit->bucket = bucket;
+        hit->index = i + first + run;
+        return ITER_OK;
+    }
+
+    hit->bucket = bucket;
+    hit->index = 0;
+    return ITER_ENODATA;
+}
+
+static int hashmap_iter_split(iter_t *it, iter_t *out, size_t size) {
+    (void)size;
+
+    struct hashmap_iter *hit = ITER__CAST(it);
+    const char *begin = (const char *)hit->bucket;
+    const char *end = (const char *)hit->end;
+    size_t stride = hit->map->bucketSize;
+    size_t count = begin < end ? (size_t)(end - begin) / stride : 0;
+
+    if (count < 2)
+        return ITER_ENODATA;
+
+    struct hashmap_iter *half = ITER__CAST(out);
+    *out = *it;
+    half->bucket = PF_OFFSET(hit->bucket, count / 2 * stride);
+    half->index = 0;
+    hit->end = half->bucket;
+    return ITER_OK;
+}
+
+/* Counts occupied slots of partially traversed or split iterators. */
+static void hashmap_iter_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    (void)size;
+
+    struct hashmap_iter *hit = ITER__CAST(it);
+    const hashmap_t *map = hit->map;
+    const union hashmeta *bucket = hit->bucket;
+    size_t count = 0, i = hit->index;
+
+    if (bucket == map->buffer && i == 0
+        && hit->end == get_meta(map, bucket_count(map))) {
+        *lower = *upper = map->count;
+        return;
+    }
+
+    for (; bucket < hit->end; bucket = PF_OFFSET(bucket, map->bucketSize)) {
+        if (i < META_SIZE)
+            count += (size_t)__builtin_popcountll(meta_used(bucket) >> i);
+        i = 0;
+    }
+
+    *lower = *upper = count;
+}
+
+static const struct iter_ops hashmap_iter_ops = {
+    hashmap_iter_next_n,
+    hashmap_iter_next_span,
+    hashmap_iter_split,
+    hashmap_iter_size_hint,
+};
+
+static const struct iter_ops hashmap_iter_ref_ops = {
+    hashmap_iter_ref_next_n,
+    NULL,
+    hashmap_iter_split,
+    hashmap_iter_size_hint,
+};
+
 iter_t *hashmap__iter(hashmap_t *map, iter_t *out) {
     if (!map || !out)
         return NULL;
@@ -591,8 +800,10 @@ iter_t *hashmap__iter(hashmap_t *map, iter_t *out) {
     struct hashmap_iter *hit = ITER__CAST(out);
 
     out->call = &hashmap_iter_fn;
+    out->ops = &hashmap_iter_ops;
     hit->map = map;
     hit->bucket = map->buffer;
+    hit->end = get_meta(map, bucket_count(map));
     hit->index = 0;
     return out;
 }
@@ -604,8 +815,10 @@ iter_t *hashmap__iter_ref(hashmap_t *map, iter_t *out) {
     struct hashmap_iter *hit = ITER__CAST(out);
 
     out->call = &hashmap_iter_ref_fn;
+    out->ops = &hashmap_iter_ref_ops;
     hit->map = map;
     hit->bucket = map->buffer;
+    hit->end = get_meta(map, bucket_count(map));
     hit->index = 0;
     return out;
 }
@@ -16,20 +16,69 @@ struct array_iter {
     size_t size;
 };
 
-size_t iter__to_array(iter_t *it, void *out, size_t length, size_t stride) {
-    if (!it || !out || stride == 0)
+ITER__ASSERT_FITS(struct array_iter);
+
+size_t iter__next_n(iter_t *it, void *out, size_t max, size_t size) {
+    if (!it || !it->call || !out || size == 0)
         return 0;
 
-    for (size_t i = 0; i < length; i++) {
-        void *slot = PF_OFFSET(out, stride * i);
-        if (iter__call(it, slot, stride, 0))
+    const struct iter_ops *ops = iter__ops(it);
+    if (ops && ops->next_n)
+        return ops->next_n(it, out, max, size);
+
+    for (size_t i = 0; i < max; i++) {
+        if (it->call(it, PF_OFFSET(out, size * i), size, 0))
             return i;
     }
 
-    return length;
+    return max;
+}
+
+int iter__next_span(
+    iter_t *it, const void **items, size_t *count, uint64_t *mask, size_t size
+) {
+    if (!it || !it->call || !items || !count || size == 0)
+        return ITER_EINVAL;
+
+    const struct iter_ops *ops = iter__ops(it);
+    if (!ops || !ops->next_span)
+        return ITER_ENOSYS;
+
+    return ops->next_span(it, items, count, mask, size);
+}
+
+iter_t *iter__split(iter_t *it, iter_t *out, size_t size) {
+    if (!it || !it->call || !out || out == it || size == 0)
+        return NULL;
+
+    const struct iter_ops *ops = iter__ops(it);
+    if (!ops || !ops->split || ops->split(it, out, size))
+        return NULL;
+
+    return out;
+}
+
+void iter__size_hint(iter_t *it, size_t *lower, size_t *upper, size_t size) {
+    const struct iter_ops *ops = size > 0 ? iter__ops(it) : NULL;
+    size_t lo = 0, hi = SIZE_MAX;
+
+    if (ops && ops->size_hint)
+        ops->size_hint(it, &lo, &hi, size);
+
+    if (lower)
+        *lower = lo;
+    if (upper)
+        *upper = hi;
+}
+
+size_t iter__to_array(iter_t *it, void *out, size_t length, size_t stride) {
+    return iter__next_n(it, out, length, stride);
 }
 
 static int array_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
     if (!it || size == 0 || it == out)
         return ITER_EINVAL;
 
@@ -42,10 +91,13 @@ static int array_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
     }
 
     if (skip) {
-        ait->current += size * skip;
-
-        if (ait->current >= ait->end)
+        /* compared in items, so that huge skips can't overflow. */
+        if (skip >= (size_t)(ait->end - ait->current) / size) {
+            ait->current = ait->end;
             return ITER_ENODATA;
+        }
+
+        ait->current += size * skip;
     }
 
     if (out) {
@@ -61,6 +113,90 @@ static int array_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
     return ITER_OK;
 }
 
+static size_t array_next_n(iter_t *it, void *out, size_t max, size_t size) {
+    struct array_iter *ait = ITER__CAST(it);
+    size_t stride = ait->size ? ait->size : size;
+
+    if (ait->size > 0 && size != sizeof(void *))
+        return 0;
+
+    if (ait->current >= ait->end)
+        return 0;
+
+    size_t count = PF_MIN(max, (size_t)(ait->end - ait->current) / stride);
+
+    if (ait->size == 0) {
+        memcpy(out, ait->current, count * size);
+    } else {
+        const void **refs = out;
+        for (size_t i = 0; i < count; i++)
+            refs[i] = ait->current + i * stride;
+    }
+
+    ait->current += count * stride;
+    return count;
+}
+
+static int array_next_span(
+    iter_t *it, const void **items, size_t *count, uint64_t *mask, size_t size
+) {
+    struct array_iter *ait = ITER__CAST(it);
+
+    if (ait->size > 0)
+        return ITER_ENOSYS;
+
+    if (ait->current >= ait->end || (size_t)(ait->end - ait->current) < size)
+        return ITER_ENODATA;
+
+    *items = ait->current;
+    *count = (size_t)(ait->end - ait->current) / size;
+    if (mask)
+        *mask = UINT64_MAX;
+
+    ait->current += *count * size;
+    return ITER_OK;
+}
+
+static int array_split(iter_t *it, iter_t *out, size_t size) {
+    struct array_iter *ait = ITER__CAST(it);
+    size_t stride = ait->size ? ait->size : size;
+
+    if (ait->size > 0 && size != sizeof(void *))
+        return ITER_EINVAL;
+
+    size_t count = ait->current < ait->end
+                     ? (size_t)(ait->end - ait->current) / stride
+                     : 0;
+
+    if (count < 2)
+        return ITER_ENODATA;
+
+    struct array_iter *half = ITER__CAST(out);
+    *out = *it;
+    half->current = ait->current + count / 2 * stride;
+    ait->end = half->current;
+    return ITER_OK;
+}
+
+static void array_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    struct array_iter *ait = ITER__CAST(it);
+    size_t stride = ait->size ? ait->size : size;
+
+    if (ait->current < ait->end)
+        *lower = *upper = (size_t)(ait->end - ait->current) / stride;
+    else
+        *lower = *upper = 0;
+}
+
+static const struct iter_ops array_iter_ops = {
+    array_next_n,
+    array_next_span,
+    array_split,
+    array_size_hint,
+};
+
 iter_t *iter__from_array(iter_t *out, const void *items, size_t length) {
     if (!out || !items)
         return NULL;
@@ -68,6 +204,7 @@ iter_t *iter__from_array(iter_t *out, const void *items, size_t length) {
     struct array_iter *ait = ITER__CAST(out);
 
     out->call = &array_iter_fn;
+    out->ops = &array_iter_ops;
     ait->current = items;
     ait->end = &ait->current[length];
     ait->size = 0;
@@ -83,6 +220,7 @@ iter_t *iter__ref_from_array(
     struct array_iter *ait = ITER__CAST(out);
 
     out->call = &array_iter_fn;
+    out->ops = &array_iter_ops;
     ait->current = items;
     ait->end = &ait->current[length];
     ait->size = stride;
@@ -0,0 +1,427 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <iter/hashmap.h>
+#include <iter/iter.h>
+#include <iter/vector.h>
+#include <pf_macro.h>
+#include <stdint.h>
+#include <string.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/join.h>
+
+extern allocator_t *libiter_allocator;
+
+static void write_pair(
+    void *out,
+    const void *left,
+    const void *right,
+    size_t asize,
+    size_t boffset,
+    size_t bsize
+) {
+    memcpy(out, left, asize);
+    memcpy(PF_OFFSET(out, boffset), right, bsize);
+}
+
+/*
+    `group` holds the items of `right` equal to the last key found in both
+    inputs, and `matching` is set while `left` points to an item with that
+    key. `right_item` is the first item of `right` after the group.
+*/
+struct merge_join {
+    allocator_t *allocator;
+    size_t bytes;
+    iter_t *left, *right;
+    iter_join_compare_fn *compare;
+    void *user;
+    size_t asize, boffset, bsize;
+    int status;
+    int matching;
+    vector_t group;
+    size_t index;
+    unsigned char *left_item;
+    unsigned char *right_item;
+};
+
+static void merge_join_free(iter_t *it, struct merge_join *j) {
+    vector__free(&j->group);
+    deallocate(j->allocator, j, j->bytes);
+    *(struct merge_join **)ITER__CAST(it) = NULL;
+}
+
+static int merge_join_group(struct merge_join *j) {
+    int status;
+
+    do {
+        if (vector__push(&j->group, j->right_item, j->bsize))
+            return ITER_ENOMEM;
+
+        status = iter__call(j->right, j->right_item, j->bsize, 0);
+    } while (!status && 0 == j->compare(j->left_item, j->right_item, j->user));
+
+    /* an exhausted `right` still leaves the group to be paired. */
+    j->status = status;
+    j->matching = 1;
+    j->index = 0;
+    return status == ITER_ENODATA ? ITER_OK : status;
+}
+
+static int merge_join_next(struct merge_join *j, void *out) {
+    for (;;) {
+        if (j->matching) {
+            unsigned char *group = j->group.items;
+
+            if (j->index * j->bsize < j->group.length) {
+                if (out) {
+                    write_pair(
+                        out, j->left_item, &group[j->index * j->bsize],
+                        j->asize, j->boffset, j->bsize
+                    );
+                }
+
+                j->index++;
+                return ITER_OK;
+            }
+
+            int status = iter__call(j->left, j->left_item, j->asize, 0);
+            if (status)
+                return status;
+
+            if (0 == j->compare(j->left_item, group, j->user)) {
+                j->index = 0;
+                continue;
+            }
+
+            j->matching = 0;
+            j->group.length = 0;
+        }
+
+        if (j->status)
+            return j->status;
+
+        int diff = j->compare(j->left_item, j->right_item, j->user);
+
+        if (diff > 0) {
+            j->status = iter__call(j->right, j->right_item, j->bsize, 0);
+            continue;
+        }
+
+        int status = diff < 0
+                       ? iter__call(j->left, j->left_item, j->asize, 0)
+                       : merge_join_group(j);
+        if (status)
+            return status;
+    }
+}
+
+static int merge_join_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (!it)
+        return ITER_EINVAL;
+
+    struct merge_join *j = *(struct merge_join **)ITER__CAST(it);
+
+    if (it == out) {
+        if (j)
+            merge_join_free(it, j);
+        return ITER_OK;
+    }
+
+    if (!j)
+        return ITER_ENODATA;
+
+    if (size < j->boffset + j->bsize)
+        return ITER_EINVAL;
+
+    for (skip += out ? 1 : 0; skip > 0; skip--) {
+        int status = merge_join_next(j, skip == 1 ? out : NULL);
+
+        if (status) {
+            merge_join_free(it, j);
+            return status;
+        }
+    }
+
+    return ITER_OK;
+}
+
+iter_t *iter__merge_join(
+    iter_t *out,
+    iter_t *left,
+    iter_t *right,
+    iter_join_compare_fn *cmp,
+    void *user,
+    allocator_t *allocator,
+    size_t asize,
+    size_t boffset,
+    size_t bsize
+) {
+    if (!out || !left || !right || !cmp || asize == 0 || bsize == 0
+        || boffset < asize)
+        return NULL;
+
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    size_t align = alignof(max_align_t);
+    size_t offset = PF_ALIGN_UP(sizeof(struct merge_join), align);
+    size_t roffset = offset + PF_ALIGN_UP(asize, align);
+    size_t bytes = roffset + bsize;
+
+    struct merge_join *j = allocate(allocator, bytes);
+    if (!j)
+        return NULL;
+
+    memset(j, 0, sizeof(*j));
+    j->allocator = allocator;
+    j->bytes = bytes;
+    j->left = left;
+    j->right = right;
+    j->compare = cmp;
+    j->user = user;
+    j->asize = asize;
+    j->boffset = boffset;
+    j->bsize = bsize;
+    j->left_item = PF_OFFSET(j, offset);
+    j->right_item = PF_OFFSET(j, roffset);
+    vector__init(&j->group, allocator);
+
+    /* joins with an empty input start exhausted. */
+    j->status = iter__call(left, j->left_item, asize, 0);
+    if (!j->status)
+        j->status = iter__call(right, j->right_item, bsize, 0);
+
+    out->call = &merge_join_fn;
+    out->ops = NULL;
+    *(struct merge_join **)ITER__CAST(out) = j;
+    return out;
+}
+
+#define ROW_NONE SIZE_MAX
+
+/* First and last row with a key, rows are linked in the order they came. */
+struct chain {
+    size_t head;
+    size_t tail;
+};
+
+/*
+    Rows of the smaller side are stored in `rows` as the index of the next
+    row with the same key, followed by the item. `row` is the next row to
+    pair with `item`, the current item of the streamed side.
+*/
+struct hash_join {
+    allocator_t *allocator;
+    size_t bytes;
+    iter_t *probe;
+    iter_key_fn *probe_key;
+    void *user;
+    int build_left;
+    size_t asize, boffset, bsize;
+    size_t isize, psize, stride;
+    hashmap_t map;
+    vector_t rows;
+    size_t row;
+    unsigned char *item;
+    unsigned char *key;
+};
+
+static void hash_join_free(iter_t *it, struct hash_join *j) {
+    hashmap__free(&j->map);
+    vector__free(&j->rows);
+    deallocate(j->allocator, j, j->bytes);
+
+    if (it)
+        *(struct hash_join **)ITER__CAST(it) = NULL;
+}
+
+static unsigned char *hash_join_row(struct hash_join *j, size_t row) {
+    return (unsigned char *)j->rows.items + row * j->stride;
+}
+
+static int hash_join_next(struct hash_join *j, void *out) {
+    while (j->row == ROW_NONE) {
+        int status = iter__call(j->probe, j->item, j->psize, 0);
+        if (status)
+            return status;
+
+        memset(j->key, 0, j->map.ksize);
+        j->probe_key(j->key, j->item, j->user);
+
+        struct chain *chain = hashmap__get(&j->map, j->key);
+        j->row = chain ? chain->head : ROW_NONE;
+    }
+
+    unsigned char *row = hash_join_row(j, j->row);
+    memcpy(&j->row, row, sizeof(size_t));
+
+    if (out) {
+        const void *left = j->build_left ? row + sizeof(size_t) : j->item;
+        const void *right = j->build_left ? j->item : row + sizeof(size_t);
+        write_pair(out, left, right, j->asize, j->boffset, j->bsize);
+    }
+
+    return ITER_OK;
+}
+
+static int hash_join_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (!it)
+        return ITER_EINVAL;
+
+    struct hash_join *j = *(struct hash_join **)ITER__CAST(it);
+
+    if (it == out) {
+        if (j)
+            hash_join_free(it, j);
+        return ITER_OK;
+    }
+
+    if (!j)
+        return ITER_ENODATA;
+
+    if (size < j->boffset + j->bsize)
+        return ITER_EINVAL;
+
+    for (skip += out ? 1 : 0; skip > 0; skip--) {
+        int status = hash_join_next(j, skip == 1 ? out : NULL);
+
+        if (status) {
+            hash_join_free(it, j);
+            return status;
+        }
+    }
+
+    return ITER_OK;
+}
+
+static int hash_join_build(
+    struct hash_join *j, iter_t *build, iter_key_fn *build_key
+) {
+    size_t lower, upper;
+    iter__size_hint(build, &lower, &upper, j->isize);
+
+    if (lower > 0 && lower <= SIZE_MAX / j->stride) {
+        if (vector__reserve(&j->rows, lower * j->stride)
+            || hashmap__reserve(&j->map, lower))
+            return ITER_ENOMEM;
+    }
+
+    for (size_t index = 0;; index++) {
+        if (vector__reserve(&j->rows, j->stride))
+            return ITER_ENOMEM;
+
+        unsigned char *row = vector__end(&j->rows);
+        int status = iter__call(build, row + sizeof(size_t), j->isize, 0);
+
+        if (status)
+            return status == ITER_ENODATA ? ITER_OK : status;
+
+        size_t next = ROW_NONE;
+        memcpy(row, &next, sizeof(size_t));
+        j->rows.length += j->stride;
+
+        memset(j->key, 0, j->map.ksize);
+        build_key(j->key, row + sizeof(size_t), j->user);
+
+        struct chain *chain = hashmap__get(&j->map, j->key);
+
+        if (chain) {
+            memcpy(hash_join_row(j, chain->tail), &index, sizeof(size_t));
+            chain->tail = index;
+            continue;
+        }
+
+        struct chain first = { index, index };
+        if (hashmap__fast_insert(&j->map, j->key, &first))
+            return ITER_ENOMEM;
+    }
+}
+
+/* Sizes that aren't known are treated as larger than every known size. */
+static int is_smaller(iter_t *it, size_t size, iter_t *other, size_t osize) {
+    size_t lower, upper, olower, oupper;
+
+    iter__size_hint(it, &lower, &upper, size);
+    iter__size_hint(other, &olower, &oupper, osize);
+    return upper < oupper;
+}
+
+iter_t *iter__hash_join(
+    iter_t *out,
+    iter_t *left,
+    iter_t *right,
+    iter_key_fn *left_key,
+    iter_key_fn *right_key,
+    void *user,
+    allocator_t *allocator,
+    size_t asize,
+    size_t boffset,
+    size_t bsize,
+    size_t ksize
+) {
+    if (!out || !left || !right || !left_key || !right_key || asize == 0
+        || bsize == 0 || boffset < asize || ksize == 0)
+        return NULL;
+
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    int build_left = !is_smaller(right, bsize, left, asize);
+    size_t isize = build_left ? asize : bsize;
+    size_t psize = build_left ? bsize : asize;
+
+    size_t align = alignof(max_align_t);
+    size_t offset = PF_ALIGN_UP(sizeof(struct hash_join), align);
+    size_t koffset = offset + PF_ALIGN_UP(psize, align);
+    size_t bytes = koffset + ksize;
+
+    struct hash_join *j = allocate(allocator, bytes);
+    if (!j)
+        return NULL;
+
+    const struct hashmap_layout layout = {
+        ksize, 1, sizeof(struct chain), alignof(struct chain),
+    };
+
+    memset(j, 0, sizeof(*j));
+    j->allocator = allocator;
+    j->bytes = bytes;
+    j->probe = build_left ? right : left;
+    j->probe_key = build_left ? right_key : left_key;
+    j->user = user;
+    j->build_left = build_left;
+    j->asize = asize;
+    j->boffset = boffset;
+    j->bsize = bsize;
+    j->isize = isize;
+    j->psize = psize;
+    j->stride = sizeof(size_t) + isize;
+    j->row = ROW_NONE;
+    j->item = PF_OFFSET(j, offset);
+    j->key = PF_OFFSET(j, koffset);
+
+    hashmap__init(&j->map, allocator, &layout);
+    vector__init(&j->rows, allocator);
+
+    int status = hash_join_build(
+        j, build_left ? left : right, build_left ? left_key : right_key
+    );
+
+    if (status) {
+        hash_join_free(NULL, j);
+        return NULL;
+    }
+
+    out->call = &hash_join_fn;
+    out->ops = NULL;
+    *(struct hash_join **)ITER__CAST(out) = j;
+    return out;
+}
@@ -0,0 +1,216 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <iter/vector.h>
+#include <pf_macro.h>
+#include <stdint.h>
+#include <string.h>
+
+extern allocator_t *libiter_allocator;
+
+/*
+    Loser tree over `k` sources. Internal nodes `tree[1..k-1]` store the
+    losers of their matches and `tree[0]` stores the overall winner, so
+    replacing the winner's item only replays matches on its path to the root.
+
+    `head[i]` points to the current item of source `i`, or is `NULL` once the
+    source is exhausted. Exhausted sources lose every match, and ties are won
+    by the source with the smaller index, which keeps the merge stable.
+*/
+struct loser_tree {
+    size_t k, size;
+    iter_compare_fn *compare;
+    size_t *tree;
+    const void **head;
+};
+
+static int tree_beats(const struct loser_tree *lt, size_t x, size_t y) {
+    /* index `k` is only used while building, it beats every source. */
+    if (x == lt->k || y == lt->k)
+        return x == lt->k;
+
+    if (!lt->head[x] || !lt->head[y])
+        return lt->head[x] ? 1 : (lt->head[y] ? 0 : x < y);
+
+    int diff = lt->compare(lt->head[x], lt->head[y], lt->size);
+    return diff < 0 || (diff == 0 && x < y);
+}
+
+static void tree_adjust(struct loser_tree *lt, size_t s) {
+    for (size_t t = (s + lt->k) / 2; t > 0; t /= 2) {
+        if (tree_beats(lt, lt->tree[t], s))
+            PF_SWAP(s, lt->tree[t]);
+    }
+
+    lt->tree[0] = s;
+}
+
+static void tree_build(struct loser_tree *lt) {
+    for (size_t i = 0; i < PF_MAX(lt->k, 1); i++)
+        lt->tree[i] = lt->k;
+
+    for (size_t i = lt->k; i > 0; i--)
+        tree_adjust(lt, i - 1);
+}
+
+struct merger {
+    struct loser_tree lt;
+    allocator_t *allocator;
+    size_t bytes;
+    iter_t **inputs;
+    unsigned char *buffer;
+};
+
+static void merger_free(iter_t *it, struct merger *m) {
+    deallocate(m->allocator, m, m->bytes);
+    *(struct merger **)ITER__CAST(it) = NULL;
+}
+
+static int merge_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (!it)
+        return ITER_EINVAL;
+
+    struct merger *m = *(struct merger **)ITER__CAST(it);
+
+    if (it == out) {
+        if (m)
+            merger_free(it, m);
+        return ITER_OK;
+    }
+
+    if (!m)
+        return ITER_ENODATA;
+
+    if (size != m->lt.size)
+        return ITER_EINVAL;
+
+    for (skip += out ? 1 : 0; skip > 0; skip--) {
+        size_t w = m->lt.tree[0];
+
+        if (w >= m->lt.k || !m->lt.head[w]) {
+            merger_free(it, m);
+            return ITER_ENODATA;
+        }
+
+        if (out && skip == 1)
+            memcpy(out, m->lt.head[w], size);
+
+        void *slot = &m->buffer[w * size];
+        if (iter__call(m->inputs[w], slot, size, 0))
+            m->lt.head[w] = NULL;
+
+        tree_adjust(&m->lt, w);
+    }
+
+    return ITER_OK;
+}
+
+iter_t *iter__merge(
+    iter_t *out,
+    iter_t **inputs,
+    size_t k,
+    size_t size,
+    iter_compare_fn *cmp,
+    allocator_t *allocator
+) {
+    if (!out || (!inputs && k > 0) || size == 0 || !cmp)
+        return NULL;
+
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    size_t bytes = sizeof(struct merger);
+    bytes += PF_ALIGN_PAD(bytes, sizeof(void *));
+    bytes += PF_MAX(k, 1) * sizeof(size_t) + k * sizeof(void *) * 2;
+    bytes += PF_ALIGN_PAD(bytes, alignof(max_align_t)) + k * size;
+
+    struct merger *m = allocate(allocator, bytes);
+    if (!m)
+        return NULL;
+
+    m->allocator = allocator;
+    m->bytes = bytes;
+    m->lt.k = k;
+    m->lt.size = size;
+    m->lt.compare = cmp;
+    m->lt.tree = PF_OFFSET(m, PF_ALIGN_UP(sizeof(*m), sizeof(void *)));
+    m->lt.head = (const void **)&m->lt.tree[PF_MAX(k, 1)];
+    m->inputs = (iter_t **)&m->lt.head[k];
+    m->buffer = PF_OFFSET(m, bytes - k * size);
+
+    for (size_t i = 0; i < k; i++) {
+        void *slot = &m->buffer[i * size];
+        m->inputs[i] = inputs[i];
+        m->lt.head[i] = iter__call(inputs[i], slot, size, 0) ? NULL : slot;
+    }
+
+    tree_build(&m->lt);
+
+    out->call = &merge_iter_fn;
+    out->ops = NULL;
+    *(struct merger **)ITER__CAST(out) = m;
+    return out;
+}
+
+int vector__merge_k(
+    vector_t *out,
+    vector_t **inputs,
+    size_t k,
+    size_t size,
+    vector_compare_fn *cmp
+) {
+    if (!out || (!inputs && k > 0) || size == 0 || !cmp)
+        return ITER_EINVAL;
+
+    size_t total = 0;
+    for (size_t i = 0; i < k; i++) {
+        if (!inputs[i] || inputs[i] == out)
+            return ITER_EINVAL;
+        if (inputs[i]->length > SIZE_MAX - total)
+            return ITER_ENOMEM;
+        total += inputs[i]->length;
+    }
+
+    if (total == 0)
+        return ITER_OK;
+
+    if (vector__unshare(out) || vector__reserve(out, total))
+        return ITER_ENOMEM;
+
+    allocator_t *allocator = out->allocator ? out->allocator
+                                            : libiter_allocator;
+    size_t bytes = k * (sizeof(size_t) + sizeof(void *));
+    size_t *tree = allocate(allocator, bytes);
+    if (!tree)
+        return ITER_ENOMEM;
+
+    struct loser_tree lt = { k, size, cmp, tree, (const void **)&tree[k] };
+
+    for (size_t i = 0; i < k; i++)
+        lt.head[i] = inputs[i]->length > 0 ? inputs[i]->items : NULL;
+
+    tree_build(&lt);
+
+    for (size_t w = tree[0]; lt.head[w]; w = tree[0]) {
+        const unsigned char *item = lt.head[w];
+        memcpy(vector__end(out), item, size);
+        out->length += size;
+
+        item += size;
+        if (item >= (unsigned char *)vector__end(inputs[w]))
+            item = NULL;
+
+        lt.head[w] = item;
+        tree_adjust(&lt, w);
+    }
+
+    deallocate(allocator, tree, bytes);
+    return ITER_OK;
+}
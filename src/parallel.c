@@ -0,0 +1,932 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <iter/vector.h>
+#include <pf_macro.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/parallel.h>
+
+#include "vector_internal.h"
+
+#ifndef ITER_NO_THREADS
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+extern allocator_t *libiter_allocator;
+
+#define CACHE_LINE 64
+#define PARALLEL_MAX_THREADS 256
+#define PARALLEL_GRAIN_BYTES 16384
+#define PARALLEL_ITER_PARTS 64
+#define PARALLEL_ITER_BATCH 4096
+
+static size_t thread_count = 0;
+
+#ifndef ITER_NO_THREADS
+
+/*
+    Every participant of a job owns a range of chunk indexes. The owner takes
+    chunks from the front of its range, while thieves take the back half.
+    Ranges are guarded by a spinlock, since they are only held for a few
+    instructions.
+*/
+struct range {
+    char lock;
+    size_t begin;
+    size_t end;
+} __attribute__((aligned(CACHE_LINE)));
+
+struct job {
+    parallel_fn *fn;
+    void *user;
+    size_t participants;
+    int stop;
+    struct range ranges[PARALLEL_MAX_THREADS];
+};
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    pthread_mutex_t submit;
+
+    struct job *job;
+    size_t generation;
+    size_t running;
+    size_t threads;
+    size_t requested;
+    pthread_t handles[PARALLEL_MAX_THREADS];
+} pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+    .submit = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static __thread int in_pool = 0;
+
+static inline void range_lock(struct range *r) {
+    while (__atomic_test_and_set(&r->lock, __ATOMIC_ACQUIRE))
+        ;
+}
+
+static inline void range_unlock(struct range *r) {
+    __atomic_clear(&r->lock, __ATOMIC_RELEASE);
+}
+
+static int range_pop(struct range *r, size_t *out) {
+    int found = 0;
+
+    range_lock(r);
+    if (r->begin < r->end) {
+        *out = r->begin++;
+        found = 1;
+    }
+    range_unlock(r);
+    return found;
+}
+
+static int range_steal(struct job *job, size_t self) {
+    for (size_t k = 1; k < job->participants; k++) {
+        struct range *victim = &job->ranges[(self + k) % job->participants];
+        size_t begin = 0, end = 0;
+
+        range_lock(victim);
+        if (victim->begin < victim->end) {
+            end = victim->end;
+            begin = victim->end - (victim->end - victim->begin + 1) / 2;
+            victim->end = begin;
+        }
+        range_unlock(victim);
+
+        if (begin < end) {
+            struct range *own = &job->ranges[self];
+            range_lock(own);
+            own->begin = begin;
+            own->end = end;
+            range_unlock(own);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void participate(struct job *job, size_t self) {
+    size_t chunk;
+
+    for (;;) {
+        if (!range_pop(&job->ranges[self], &chunk)) {
+            if (!range_steal(job, self))
+                break;
+            continue;
+        }
+
+        if (__atomic_load_n(&job->stop, __ATOMIC_RELAXED))
+            continue;
+
+        if (job->fn(chunk, job->user))
+            __atomic_store_n(&job->stop, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void *worker(void *arg) {
+    size_t self = (size_t)arg;
+    size_t generation = 0;
+
+    in_pool = 1;
+    pthread_mutex_lock(&pool.lock);
+
+    for (;;) {
+        while (pool.generation == generation)
+            pthread_cond_wait(&pool.wake, &pool.lock);
+
+        generation = pool.generation;
+        struct job *job = pool.job;
+
+        if (!job)
+            break;
+
+        if (self >= job->participants)
+            continue;
+
+        pthread_mutex_unlock(&pool.lock);
+        participate(job, self);
+        pthread_mutex_lock(&pool.lock);
+
+        if (--pool.running == 0)
+            pthread_cond_signal(&pool.done);
+    }
+
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+static size_t default_threads(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+}
+
+/* must be called while holding `pool.submit`. */
+static void pool_stop(void) {
+    pthread_mutex_lock(&pool.lock);
+    pool.job = NULL;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (size_t i = 1; i < pool.threads; i++)
+        pthread_join(pool.handles[i], NULL);
+
+    pool.threads = 0;
+    pool.requested = 0;
+    pool.generation = 0;
+}
+
+/* must be called while holding `pool.submit`. */
+static size_t pool_start(void) {
+    size_t count = thread_count ? thread_count : default_threads();
+    count = PF_MIN(count, PARALLEL_MAX_THREADS);
+
+    /* a pool that only partially started is kept, instead of rebuilt. */
+    if (pool.requested == count)
+        return pool.threads;
+
+    if (pool.threads > 0)
+        pool_stop();
+
+    /* index 0 is reserved for the thread submitting the job. */
+    pool.requested = count;
+    pool.threads = 1;
+    for (size_t i = 1; i < count; i++) {
+        if (pthread_create(&pool.handles[i], NULL, worker, (void *)i))
+            break;
+        pool.threads++;
+    }
+
+    return pool.threads;
+}
+
+size_t libiter_use_threads(size_t count) {
+    size_t prev = thread_count ? thread_count : default_threads();
+    thread_count = count;
+    return prev;
+}
+
+int parallel_for(size_t count, parallel_fn *fn, void *user) {
+    if (!fn)
+        return ITER_EINVAL;
+
+    if (count <= 1 || in_pool) {
+        for (size_t i = 0; i < count; i++)
+            if (fn(i, user))
+                return ITER_EINTR;
+        return ITER_OK;
+    }
+
+    static struct job job;
+
+    pthread_mutex_lock(&pool.submit);
+
+    size_t participants = PF_MIN(pool_start(), count);
+
+    job.fn = fn;
+    job.user = user;
+    job.stop = 0;
+    job.participants = participants;
+
+    for (size_t i = 0; i < participants; i++) {
+        job.ranges[i].lock = 0;
+        job.ranges[i].begin = count * i / participants;
+        job.ranges[i].end = count * (i + 1) / participants;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.job = &job;
+    pool.running = participants - 1;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    in_pool = 1;
+    participate(&job, 0);
+    in_pool = 0;
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.running > 0)
+        pthread_cond_wait(&pool.done, &pool.lock);
+    pthread_mutex_unlock(&pool.lock);
+
+    int stop = job.stop;
+    pthread_mutex_unlock(&pool.submit);
+    return stop ? ITER_EINTR : ITER_OK;
+}
+
+#else
+
+size_t libiter_use_threads(size_t count) {
+    size_t prev = thread_count ? thread_count : 1;
+    thread_count = count;
+    return prev;
+}
+
+int parallel_for(size_t count, parallel_fn *fn, void *user) {
+    if (!fn)
+        return ITER_EINVAL;
+
+    for (size_t i = 0; i < count; i++)
+        if (fn(i, user))
+            return ITER_EINTR;
+
+    return ITER_OK;
+}
+
+#endif
+
+/* Rounds `grain` up, so that every chunk starts at a cache line. */
+static size_t chunk_grain(size_t grain, size_t size) {
+    size_t align = CACHE_LINE;
+
+    for (size_t odd = size; align > 1 && odd % 2 == 0; odd /= 2)
+        align /= 2;
+
+    if (grain == 0)
+        grain = PF_MAX(PARALLEL_GRAIN_BYTES / size, 1);
+
+    return PF_ALIGN_UP(grain, align);
+}
+
+struct chunks {
+    vector_t *dst, *src;
+    void *user;
+    size_t grain, count;
+    size_t dsize, ssize;
+    void *partials;
+    const void *identity;
+
+    union {
+        vector_each_fn *each;
+        vector_map_fn *map;
+        vector_reduce_fn *combine;
+    } fn;
+};
+
+static int each_chunk(size_t chunk, void *user) {
+    struct chunks *c = user;
+    size_t begin = chunk * c->grain;
+    size_t end = PF_MIN(begin + c->grain, c->count);
+
+    for (size_t i = begin; i < end; i++)
+        if (c->fn.each(vector__slot(c->src, i * c->ssize), c->user))
+            return 1;
+
+    return 0;
+}
+
+static int map_chunk(size_t chunk, void *user) {
+    struct chunks *c = user;
+    size_t begin = chunk * c->grain;
+    size_t end = PF_MIN(begin + c->grain, c->count);
+    size_t offset = c->dst->length;
+
+    for (size_t i = begin; i < end; i++) {
+        void *dslot = vector__slot(c->dst, offset + i * c->dsize);
+        void *sslot = vector__slot(c->src, i * c->ssize);
+        if (c->fn.map(dslot, sslot, c->user))
+            return 1;
+    }
+
+    return 0;
+}
+
+static int reduce_chunk(size_t chunk, void *user) {
+    struct chunks *c = user;
+    size_t begin = chunk * c->grain;
+    size_t end = PF_MIN(begin + c->grain, c->count);
+    void *acc = PF_OFFSET(c->partials, chunk * c->ssize);
+
+    memcpy(acc, c->identity, c->ssize);
+    for (size_t i = begin; i < end; i++)
+        if (c->fn.combine(acc, vector__slot(c->src, i * c->ssize), c->user))
+            return 1;
+
+    return 0;
+}
+
+static inline size_t chunk_count(const struct chunks *c) {
+    return (c->count + c->grain - 1) / c->grain;
+}
+
+int vector__each_parallel(
+    vector_t *vec, vector_each_fn *each, void *user, size_t size, size_t grain
+) {
+    if (!vec || !each || size == 0)
+        return ITER_EINVAL;
+
+    if (vector__unshare(vec))
+        return ITER_ENOMEM;
+
+    struct chunks c = { 0 };
+    c.src = vec;
+    c.user = user;
+    c.ssize = size;
+    c.count = vec->length / size;
+    c.grain = chunk_grain(grain, size);
+    c.fn.each = each;
+
+    return parallel_for(chunk_count(&c), each_chunk, &c);
+}
+
+int vector__map_parallel(
+    vector_t *dst,
+    vector_t *src,
+    vector_map_fn *map,
+    void *user,
+    size_t dsize,
+    size_t ssize,
+    size_t grain
+) {
+    if (!dst || !src || !map || dsize == 0 || ssize == 0)
+        return ITER_EINVAL;
+
+    struct chunks c = { 0 };
+    c.dst = dst;
+    c.src = src;
+    c.user = user;
+    c.dsize = dsize;
+    c.ssize = ssize;
+    c.count = src->length / ssize;
+    c.grain = chunk_grain(grain, dsize);
+    c.fn.map = map;
+
+    if (c.count == 0)
+        return ITER_OK;
+
+    if (vector__unshare(dst) || vector__reserve(dst, c.count * dsize))
+        return ITER_ENOMEM;
+
+    int fail = parallel_for(chunk_count(&c), map_chunk, &c);
+    if (!fail)
+        dst->length += c.count * dsize;
+
+    return fail;
+}
+
+int vector__reduce_parallel(
+    vector_t *vec,
+    void *out,
+    const void *identity,
+    vector_reduce_fn *combine,
+    void *user,
+    size_t size,
+    size_t grain
+) {
+    if (!vec || !out || !identity || !combine || size == 0)
+        return ITER_EINVAL;
+
+    struct chunks c = { 0 };
+    c.src = vec;
+    c.user = user;
+    c.ssize = size;
+    c.count = vec->length / size;
+    c.grain = chunk_grain(grain, size);
+    c.identity = identity;
+    c.fn.combine = combine;
+
+    allocator_t *allocator = scratch_allocator(vec);
+    size_t chunks = chunk_count(&c);
+
+    memcpy(out, identity, size);
+    if (chunks == 0)
+        return ITER_OK;
+
+    c.partials = allocate(allocator, chunks * size);
+    if (!c.partials)
+        return ITER_ENOMEM;
+
+    int fail = parallel_for(chunks, reduce_chunk, &c);
+
+    for (size_t i = 0; !fail && i < chunks; i++)
+        if (combine(out, PF_OFFSET(c.partials, i * size), user))
+            fail = ITER_EINTR;
+
+    deallocate(allocator, c.partials, chunks * size);
+    return fail;
+}
+
+struct parts {
+    iter_t *parts[PARALLEL_ITER_PARTS];
+    iter_t storage[PARALLEL_ITER_PARTS - 1];
+    int status[PARALLEL_ITER_PARTS];
+    size_t count, size;
+    void *user;
+    void *partials;
+
+    union {
+        vector_each_fn *each;
+        vector_reduce_fn *combine;
+    } fn;
+};
+
+/*
+    Splits every part in two in each round, so the parts stay ordered and
+    roughly equal, until there are enough of them or none can be split.
+*/
+static void split_parts(struct parts *p, iter_t *it) {
+    iter_t *next[PARALLEL_ITER_PARTS];
+    size_t used = 0;
+
+    p->parts[0] = it;
+    p->count = 1;
+
+    while (p->count < PARALLEL_ITER_PARTS) {
+        size_t k = 0;
+
+        for (size_t j = 0; j < p->count; j++) {
+            next[k++] = p->parts[j];
+
+            if (used + 1 < PARALLEL_ITER_PARTS
+                && iter__split(p->parts[j], &p->storage[used], p->size))
+                next[k++] = &p->storage[used++];
+        }
+
+        if (k == p->count)
+            break;
+
+        memcpy(p->parts, next, k * sizeof(*next));
+        p->count = k;
+    }
+}
+
+/* Reads items of a part in batches and passes them to `each` or `combine`. */
+static int drain_part(struct parts *p, size_t index, void *acc) {
+    union {
+        max_align_t align;
+        unsigned char bytes[PARALLEL_ITER_BATCH];
+    } stack;
+
+    size_t size = p->size;
+    size_t max = PF_MAX(sizeof(stack) / size, 1);
+    void *items = size <= sizeof(stack) ? (void *)&stack
+                                        : allocate(libiter_allocator, size);
+
+    if (!items)
+        return ITER_ENOMEM;
+
+    int status = ITER_OK;
+    size_t n = max;
+
+    while (!status && n == max) {
+        n = iter__next_n(p->parts[index], items, max, size);
+
+        for (size_t i = 0; !status && i < n; i++) {
+            void *item = PF_OFFSET(items, i * size);
+            int stop = acc ? p->fn.combine(acc, item, p->user)
+                           : p->fn.each(item, p->user);
+            if (stop)
+                status = ITER_EINTR;
+        }
+    }
+
+    if (items != (void *)&stack)
+        deallocate(libiter_allocator, items, size);
+    return status;
+}
+
+static int each_part(size_t index, void *user) {
+    struct parts *p = user;
+    p->status[index] = drain_part(p, index, NULL);
+    return p->status[index] != ITER_OK;
+}
+
+static int reduce_part(size_t index, void *user) {
+    struct parts *p = user;
+    void *acc = PF_OFFSET(p->partials, index * p->size);
+    p->status[index] = drain_part(p, index, acc);
+    return p->status[index] != ITER_OK;
+}
+
+/* `it` is always the first part, the rest are owned by the job. */
+static void free_parts(struct parts *p) {
+    for (size_t i = 1; i < p->count; i++)
+        iter__call(p->parts[i], p->parts[i], p->size, 0);
+}
+
+/* A part that ran out of memory takes precedence over interrupted ones. */
+static int parts_status(const struct parts *p, int fail) {
+    for (size_t i = 0; fail && i < p->count; i++)
+        if (p->status[i] == ITER_ENOMEM)
+            return ITER_ENOMEM;
+
+    return fail ? ITER_EINTR : ITER_OK;
+}
+
+int iter__parallel_each(
+    iter_t *it, vector_each_fn *each, void *user, size_t size
+) {
+    if (!it || !it->call || !each || size == 0)
+        return ITER_EINVAL;
+
+    struct parts p;
+    p.size = size;
+    p.user = user;
+    p.fn.each = each;
+
+    split_parts(&p, it);
+    memset(p.status, 0, sizeof(p.status));
+
+    int fail = parts_status(&p, parallel_for(p.count, each_part, &p));
+
+    free_parts(&p);
+    return fail;
+}
+
+int iter__parallel_reduce(
+    iter_t *it,
+    void *out,
+    const void *identity,
+    vector_reduce_fn *combine,
+    void *user,
+    size_t size
+) {
+    if (!it || !it->call || !out || !identity || !combine || size == 0)
+        return ITER_EINVAL;
+
+    struct parts p;
+    p.size = size;
+    p.user = user;
+    p.fn.combine = combine;
+
+    split_parts(&p, it);
+    memset(p.status, 0, sizeof(p.status));
+
+    p.partials = allocate(libiter_allocator, p.count * size);
+    if (!p.partials) {
+        free_parts(&p);
+        return ITER_ENOMEM;
+    }
+
+    for (size_t i = 0; i < p.count; i++)
+        memcpy(PF_OFFSET(p.partials, i * size), identity, size);
+
+    int fail = parts_status(&p, parallel_for(p.count, reduce_part, &p));
+    free_parts(&p);
+
+    memcpy(out, identity, size);
+    for (size_t i = 0; !fail && i < p.count; i++)
+        if (combine(out, PF_OFFSET(p.partials, i * size), user))
+            fail = ITER_EINTR;
+
+    deallocate(libiter_allocator, p.partials, p.count * size);
+    return fail;
+}
+
+#define PREFETCH_BATCH_BYTES 16384
+#define PREFETCH_SPINS 64
+
+struct prefetch_slot {
+    unsigned char *items;
+    size_t count;
+    int status;
+};
+
+/*
+    The producer reads batches into the slot at `tail % depth` and the
+    consumer takes them from the slot at `head % depth`, of which `pos`
+    items have been used. Each index is only written by one thread, so
+    a batch is passed by storing the index, without locks. `waiting` counts
+    threads sleeping on `wake`, so that `lock` is only taken when one of
+    them has to be woken up. Indexes are kept on separate cache lines.
+*/
+struct prefetch {
+    allocator_t *allocator;
+    size_t bytes;
+    iter_t *src;
+    size_t size, batch, depth;
+    struct prefetch_slot *slots;
+    size_t pos;
+    int threaded;
+    int cancel;
+
+    char pad_head[CACHE_LINE];
+    size_t head;
+    char pad_tail[CACHE_LINE];
+    size_t tail;
+    char pad_end[CACHE_LINE];
+
+#ifndef ITER_NO_THREADS
+    int waiting;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+#endif
+};
+
+static int prefetch_fill(struct prefetch *p, size_t tail) {
+    struct prefetch_slot *slot = &p->slots[tail % p->depth];
+
+    slot->count = iter__next_n(p->src, slot->items, p->batch, p->size);
+    slot->status = slot->count < p->batch ? ITER_ENODATA : ITER_OK;
+    return slot->status;
+}
+
+#ifndef ITER_NO_THREADS
+
+static int prefetch_ready(struct prefetch *p, int producer) {
+    size_t head = __atomic_load_n(&p->head, __ATOMIC_SEQ_CST);
+    size_t tail = __atomic_load_n(&p->tail, __ATOMIC_SEQ_CST);
+
+    if (!producer)
+        return head != tail;
+
+    return tail - head < p->depth
+        || __atomic_load_n(&p->cancel, __ATOMIC_SEQ_CST);
+}
+
+/* Spins for a while, then sleeps until the other thread moves its index. */
+static void prefetch_wait(struct prefetch *p, int producer) {
+    for (int i = 0; i < PREFETCH_SPINS; i++)
+        if (prefetch_ready(p, producer))
+            return;
+
+    pthread_mutex_lock(&p->lock);
+    __atomic_fetch_add(&p->waiting, 1, __ATOMIC_SEQ_CST);
+
+    while (!prefetch_ready(p, producer))
+        pthread_cond_wait(&p->wake, &p->lock);
+
+    __atomic_fetch_sub(&p->waiting, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void prefetch_wake(struct prefetch *p) {
+    if (!__atomic_load_n(&p->waiting, __ATOMIC_SEQ_CST))
+        return;
+
+    pthread_mutex_lock(&p->lock);
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+}
+
+static void *prefetch_worker(void *arg) {
+    struct prefetch *p = arg;
+    size_t tail = p->tail;
+
+    for (int status = ITER_OK; !status; tail++) {
+        prefetch_wait(p, 1);
+
+        if (__atomic_load_n(&p->cancel, __ATOMIC_SEQ_CST))
+            break;
+
+        status = prefetch_fill(p, tail);
+        __atomic_store_n(&p->tail, tail + 1, __ATOMIC_SEQ_CST);
+        prefetch_wake(p);
+    }
+
+    return NULL;
+}
+
+#endif
+
+static void prefetch_free(iter_t *it, struct prefetch *p) {
+#ifndef ITER_NO_THREADS
+    if (p->threaded) {
+        __atomic_store_n(&p->cancel, 1, __ATOMIC_SEQ_CST);
+        prefetch_wake(p);
+        pthread_join(p->thread, NULL);
+        pthread_cond_destroy(&p->wake);
+        pthread_mutex_destroy(&p->lock);
+    }
+#endif
+
+    deallocate(p->allocator, p, p->bytes);
+    *(struct prefetch **)ITER__CAST(it) = NULL;
+}
+
+/* Returns the batch at `head`, once the producer has published it. */
+static struct prefetch_slot *prefetch_front(struct prefetch *p) {
+    if (!p->threaded && p->head == p->tail)
+        prefetch_fill(p, p->tail++);
+
+#ifndef ITER_NO_THREADS
+    if (p->threaded)
+        prefetch_wait(p, 0);
+#endif
+
+    return &p->slots[p->head % p->depth];
+}
+
+static void prefetch_release(struct prefetch *p) {
+    p->pos = 0;
+    __atomic_store_n(&p->head, p->head + 1, __ATOMIC_SEQ_CST);
+
+#ifndef ITER_NO_THREADS
+    if (p->threaded)
+        prefetch_wake(p);
+#endif
+}
+
+/*
+    Copies `max` items into `out`, or skips them if `out` is `NULL`, and
+    stores the number of items taken into `taken`. Returns the status of
+    the last batch once it has been used up.
+*/
+static int prefetch_take(
+    struct prefetch *p, unsigned char *out, size_t max, size_t *taken
+) {
+    for (*taken = 0; *taken < max;) {
+        struct prefetch_slot *slot = prefetch_front(p);
+        size_t count = PF_MIN(max - *taken, slot->count - p->pos);
+
+        if (out && count > 0) {
+            memcpy(
+                out + *taken * p->size,
+                slot->items + p->pos * p->size,
+                count * p->size
+            );
+        }
+
+        p->pos += count;
+        *taken += count;
+
+        if (p->pos < slot->count)
+            break;
+
+        if (slot->status)
+            return *taken == max ? ITER_OK : slot->status;
+
+        prefetch_release(p);
+    }
+
+    return ITER_OK;
+}
+
+static int prefetch_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it)
+        return ITER_EINVAL;
+
+    struct prefetch *p = *(struct prefetch **)ITER__CAST(it);
+
+    if (it == out) {
+        if (p)
+            prefetch_free(it, p);
+        return ITER_OK;
+    }
+
+    if (!p)
+        return ITER_ENODATA;
+
+    if (size != p->size)
+        return ITER_EINVAL;
+
+    size_t taken;
+    int status = prefetch_take(p, NULL, skip, &taken);
+
+    if (!status && out)
+        status = prefetch_take(p, out, 1, &taken);
+
+    if (status)
+        prefetch_free(it, p);
+    return status;
+}
+
+static size_t prefetch_next_n(iter_t *it, void *out, size_t max, size_t size) {
+    struct prefetch *p = *(struct prefetch **)ITER__CAST(it);
+    size_t taken;
+
+    if (!p || size != p->size)
+        return 0;
+
+    if (prefetch_take(p, out, max, &taken))
+        prefetch_free(it, p);
+    return taken;
+}
+
+static const struct iter_ops prefetch_iter_ops = {
+    prefetch_next_n,
+    NULL,
+    NULL,
+    NULL,
+};
+
+iter_t *iter__prefetch(
+    iter_t *out,
+    iter_t *src,
+    size_t depth,
+    allocator_t *allocator,
+    size_t size
+) {
+    if (!out || !src || depth == 0 || size == 0)
+        return NULL;
+
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    size_t align = alignof(max_align_t);
+    size_t batch = PF_MAX(PREFETCH_BATCH_BYTES / size, 1);
+
+    if (depth > SIZE_MAX / 2 / sizeof(struct prefetch_slot))
+        return NULL;
+
+    size_t soffset = PF_ALIGN_UP(sizeof(struct prefetch), align);
+    size_t ioffset = soffset
+        + PF_ALIGN_UP(depth * sizeof(struct prefetch_slot), align);
+
+    if (depth > (SIZE_MAX - ioffset) / batch / size)
+        return NULL;
+
+    size_t bytes = ioffset + depth * batch * size;
+
+    struct prefetch *p = allocate(allocator, bytes);
+    if (!p)
+        return NULL;
+
+    memset(p, 0, sizeof(*p));
+    p->allocator = allocator;
+    p->bytes = bytes;
+    p->src = src;
+    p->size = size;
+    p->batch = batch;
+    p->depth = depth;
+    p->slots = PF_OFFSET(p, soffset);
+
+    for (size_t i = 0; i < depth; i++) {
+        p->slots[i].items = PF_OFFSET(p, ioffset + i * batch * size);
+        p->slots[i].count = 0;
+        p->slots[i].status = ITER_OK;
+    }
+
+#ifndef ITER_NO_THREADS
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->wake, NULL);
+
+    /* falls back to reading batches on the calling thread. */
+    p->threaded = !pthread_create(&p->thread, NULL, prefetch_worker, p);
+
+    if (!p->threaded) {
+        pthread_cond_destroy(&p->wake);
+        pthread_mutex_destroy(&p->lock);
+    }
+#endif
+
+    out->call = &prefetch_iter_fn;
+    out->ops = &prefetch_iter_ops;
+    *(struct prefetch **)ITER__CAST(out) = p;
+    return out;
+}
@@ -225,13 +225,37 @@ int pool__each(pool_t *pool, pool_each_fn *each, void *user) {
     return ITER_OK;
 }
 
+/*
+    Iterators stop at slot `stop_index` of bucket `stop`, which is set when
+    the iterator is split, or at the end of the bucket list if `stop` is
+    `NULL`. Split points are aligned to flag words.
+*/
 struct pool_iter {
     const pool_t *pool;
     const struct bucket *bucket;
     size_t index;
+    const struct bucket *stop;
+    size_t stop_index;
 };
 
+ITER__ASSERT_FITS(struct pool_iter);
+
+static inline size_t pool_iter_end(
+    const struct pool_iter *pit, const struct bucket *bucket
+) {
+    return bucket == pit->stop ? pit->stop_index : bucket->capacity;
+}
+
+static inline const struct bucket *pool_iter_next_bucket(
+    const struct pool_iter *pit, const struct bucket *bucket
+) {
+    return bucket == pit->stop ? NULL : bucket->next;
+}
+
 static int pool_iter_ref_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
     if (!it || it == out || size != sizeof(void *))
         return ITER_EINVAL;
 
@@ -244,39 +268,40 @@ static int pool_iter_ref_fn(iter_t *it, void *out, size_t size, size_t skip) {
     if (out)
         skip++;
 
-    size_t set = i / BUCKET_SIZE;
-    size_t bit = i % BUCKET_SIZE;
-    void *value;
+    void *value = NULL;
 
     while (bucket && skip > 0) {
-        if (bucket->flags[set] & ((size_t)1 << bit)) {
-            value = PF_OFFSET(bucket->start, pool->size * i);
-            skip--;
+        if (i >= pool_iter_end(pit, bucket)) {
+            bucket = pool_iter_next_bucket(pit, bucket);
+            i = 0;
+            continue;
         }
 
-        if (++bit >= BUCKET_SIZE) {
-            set++;
-            bit = 0;
-        }
+        size_t bit = (size_t)1 << (i % BUCKET_SIZE);
 
-        if (++i >= bucket->capacity) {
-            bucket = bucket->next;
-            i = set = bit = 0;
+        if (bucket->flags[i / BUCKET_SIZE] & bit) {
+            value = PF_OFFSET(bucket->start, pool->size * i);
+            skip--;
         }
+
+        i++;
     }
 
-    i = set * BUCKET_SIZE + bit;
     pit->bucket = bucket;
     pit->index = i;
 
     if (skip > 0)
         return ITER_ENODATA;
 
-    *(void **)out = value;
+    if (out)
+        *(void **)out = value;
     return ITER_OK;
 }
 
 static int pool_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
     if (!it || it == out)
         return ITER_EINVAL;
 
@@ -294,6 +319,212 @@ static int pool_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
     return fail;
 }
 
+/*
+    Copies items by whole flag words. Runs of occupied slots are contiguous,
+    so a full word is copied with a single `memcpy`.
+*/
+static size_t pool_next_n(iter_t *it, void *out, size_t max, int ref) {
+    struct pool_iter *pit = ITER__CAST(it);
+    const pool_t *pool = pit->pool;
+    const struct bucket *bucket = pit->bucket;
+    size_t i = pit->index, n = 0;
+    unsigned char *dst = out;
+
+    while (bucket && n < max) {
+        if (i >= pool_iter_end(pit, bucket)) {
+            bucket = pool_iter_next_bucket(pit, bucket);
+            i = 0;
+            continue;
+        }
+
+        size_t set = i / BUCKET_SIZE;
+        size_t word = bucket->flags[set] & (~(size_t)0 << (i % BUCKET_SIZE));
+
+        while (word && n < max) {
+            size_t first = pf_ctzsize(word);
+            size_t run = pf_ctzsize(~(word >> first));
+
+            run = PF_MIN(run, max - n);
+            i = set * BUCKET_SIZE + first;
+
+            const unsigned char *src = PF_OFFSET(bucket->start, pool->size * i);
+
+            if (ref) {
+                for (size_t j = 0; j < run; j++)
+                    ((const void **)out)[n + j] = src + j * pool->size;
+            } else {
+                memcpy(dst + n * pool->size, src, run * pool->size);
+            }
+
+            n += run;
+            i += run;
+
+            size_t end = first + run;
+            word = end < BUCKET_SIZE ? word & (~(size_t)0 << end) : 0;
+        }
+
+        if (word)
+            break;
+
+        i = (set + 1) * BUCKET_SIZE;
+    }
+
+    pit->bucket = bucket;
+    pit->index = i;
+    return n;
+}
+
+static size_t pool_iter_next_n(
+    iter_t *it, void *out, size_t max, size_t size
+) {
+    struct pool_iter *pit = ITER__CAST(it);
+    return size == pit->pool->size ? pool_next_n(it, out, max, 0) : 0;
+}
+
+static size_t pool_iter_ref_next_n(
+    iter_t *it, void *out, size_t max, size_t size
+) {
+    return size == sizeof(void *) ? pool_next_n(it, out, max, 1) : 0;
+}
+
+/*
+    With a mask, spans cover the rest of a flag word, up to its last occupied
+    slot. Without it, they cover a single run of occupied slots.
+*/
+static int pool_iter_next_span(
+    iter_t *it, const void **items, size_t *count, uint64_t *mask, size_t size
+) {
+    struct pool_iter *pit = ITER__CAST(it);
+    const pool_t *pool = pit->pool;
+    const struct bucket *bucket = pit->bucket;
+    size_t i = pit->index;
+
+    if (size != pool->size)
+        return ITER_EINVAL;
+
+    for (; bucket; bucket = pool_iter_next_bucket(pit, bucket), i = 0) {
+        size_t end = pool_iter_end(pit, bucket);
+
+        for (; i < end; i = PF_ALIGN_UP(i + 1, BUCKET_SIZE)) {
+            size_t word = bucket->flags[i / BUCKET_SIZE] >> (i % BUCKET_SIZE);
+            size_t first = 0, run;
+
+            if (!word)
+                continue;
+
+            if (mask) {
+                run = BUCKET_SIZE - (size_t)__builtin_clzll(word);
+                *mask = word;
+            } else {
+                first = pf_ctzsize(word);
+                run = pf_ctzsize(~(word >> first));
+            }
+
+            *items = PF_OFFSET(bucket->start, (i + first) * pool->size);
+            *count = run;
+            pit->bucket = bucket;
+            pit->index = i + first + run;
+            return ITER_OK;
+        }
+    }
+
+    pit->bucket = NULL;
+    pit->index = 0;
+    return ITER_ENODATA;
+}
+
+/*
+    Splits at the flag word closest to the middle of the remaining slots.
+    Buckets grow geometrically, so there are only a few of them to walk.
+*/
+static int pool_iter_split(iter_t *it, iter_t *out, size_t size) {
+    (void)size;
+
+    struct pool_iter *pit = ITER__CAST(it);
+    const struct bucket *bucket = pit->bucket;
+    size_t total = 0, i = pit->index;
+
+    for (; bucket; bucket = pool_iter_next_bucket(pit, bucket), i = 0) {
+        size_t end = pool_iter_end(pit, bucket);
+        total += end > i ? end - i : 0;
+    }
+
+    size_t half = total / 2;
+    bucket = pit->bucket;
+    i = pit->index;
+
+    for (; bucket; bucket = pool_iter_next_bucket(pit, bucket), i = 0) {
+        size_t end = pool_iter_end(pit, bucket);
+        size_t left = end > i ? end - i : 0;
+
+        if (half < left) {
+            i = PF_ALIGN_UP(i + half, BUCKET_SIZE);
+            break;
+        }
+
+        half -= left;
+    }
+
+    if (bucket && i >= pool_iter_end(pit, bucket)) {
+        bucket = pool_iter_next_bucket(pit, bucket);
+        i = 0;
+    }
+
+    /* both halves must contain at least one flag word. */
+    if (!bucket || i >= pool_iter_end(pit, bucket)
+        || (bucket == pit->bucket && i <= pit->index))
+        return ITER_ENODATA;
+
+    struct pool_iter *half_it = ITER__CAST(out);
+    *out = *it;
+    half_it->bucket = bucket;
+    half_it->index = i;
+    pit->stop = bucket;
+    pit->stop_index = i;
+    return ITER_OK;
+}
+
+/* Counts occupied slots of partially traversed or split iterators. */
+static void pool_iter_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    (void)size;
+
+    struct pool_iter *pit = ITER__CAST(it);
+    const struct bucket *bucket = pit->bucket;
+    size_t count = 0, i = pit->index;
+
+    if (bucket == pit->pool->buffer && i == 0 && !pit->stop) {
+        *lower = *upper = pit->pool->count;
+        return;
+    }
+
+    for (; bucket; bucket = pool_iter_next_bucket(pit, bucket), i = 0) {
+        size_t end = pool_iter_end(pit, bucket);
+
+        for (; i < end; i = PF_ALIGN_UP(i + 1, BUCKET_SIZE)) {
+            size_t word = bucket->flags[i / BUCKET_SIZE] >> (i % BUCKET_SIZE);
+            count += (size_t)__builtin_popcountll(word);
+        }
+    }
+
+    *lower = *upper = count;
+}
+
+static const struct iter_ops pool_iter_ops = {
+    pool_iter_next_n,
+    pool_iter_next_span,
+    pool_iter_split,
+    pool_iter_size_hint,
+};
+
+static const struct iter_ops pool_iter_ref_ops = {
+    pool_iter_ref_next_n,
+    NULL,
+    pool_iter_split,
+    pool_iter_size_hint,
+};
+
 iter_t *pool__iter(pool_t *pool, iter_t *out) {
     if (!out || !pool)
         return NULL;
@@ -301,9 +532,12 @@ iter_t *pool__iter(pool_t *pool, iter_t *out) {
     struct pool_iter *pit = ITER__CAST(out);
 
     out->call = &pool_iter_fn;
+    out->ops = &pool_iter_ops;
     pit->pool = pool;
     pit->bucket = pool->buffer;
     pit->index = 0;
+    pit->stop = NULL;
+    pit->stop_index = 0;
     return out;
 }
 
@@ -314,8 +548,11 @@ iter_t *pool__iter_ref(pool_t *pool, iter_t *out) {
     struct pool_iter *pit = ITER__CAST(out);
 
     out->call = &pool_iter_ref_fn;
+    out->ops = &pool_iter_ref_ops;
     pit->pool = pool;
     pit->bucket = pool->buffer;
     pit->index = 0;
+    pit->stop = NULL;
+    pit->stop_index = 0;
     return out;
 }
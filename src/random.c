@@ -0,0 +1,444 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <iter/vector.h>
+#include <math.h>
+#include <pf_macro.h>
+#include <stdint.h>
+#include <string.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/parallel.h>
+#include <iter/random.h>
+
+#include "vector_internal.h"
+
+extern allocator_t *libiter_allocator;
+
+/* Buckets of the parallel shuffle should fit into the L2 cache. */
+#define SHUFFLE_BUCKET_BYTES (256 * 1024)
+#define SHUFFLE_MAX_BUCKETS 256
+
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void iter_rng_seed(iter_rng_t *rng, uint64_t seed) {
+    if (!rng)
+        return;
+
+    for (size_t i = 0; i < 4; i++)
+        rng->s[i] = splitmix64(&seed);
+}
+
+void iter_rng_jump(iter_rng_t *rng) {
+    static const uint64_t jump[] = {
+        0x180EC6D33CFD0ABAull,
+        0xD5A61266F0C9392Cull,
+        0xA9582618E03FC9AAull,
+        0x39ABDC4529B1661Cull,
+    };
+
+    if (!rng)
+        return;
+
+    uint64_t s[4] = { 0 };
+
+    for (size_t i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & ((uint64_t)1 << b)) {
+                s[0] ^= rng->s[0];
+                s[1] ^= rng->s[1];
+                s[2] ^= rng->s[2];
+                s[3] ^= rng->s[3];
+            }
+
+            iter_rng_next(rng);
+        }
+    }
+
+    memcpy(rng->s, s, sizeof(s));
+}
+
+#define SHUFFLE_TYPED(T)                                 \
+    do {                                                 \
+        T *x = items;                                    \
+        for (size_t i = count - 1; i > 0; i--) {         \
+            size_t j = iter_rng_bounded(rng, i + 1);     \
+            T tmp = x[i];                                \
+            x[i] = x[j];                                 \
+            x[j] = tmp;                                  \
+        }                                                \
+    } while (0)
+
+/* Fisher-Yates, with the swaps of common sizes done on typed items. */
+static void shuffle_items(
+    void *items, size_t count, size_t size, iter_rng_t *rng
+) {
+    if (count < 2)
+        return;
+
+    switch (size) {
+    case 1:
+        SHUFFLE_TYPED(uint8_t);
+        break;
+    case 2:
+        SHUFFLE_TYPED(uint16_t);
+        break;
+    case 4:
+        SHUFFLE_TYPED(uint32_t);
+        break;
+    case 8:
+        SHUFFLE_TYPED(uint64_t);
+        break;
+    default:
+        for (size_t i = count - 1; i > 0; i--) {
+            size_t j = iter_rng_bounded(rng, i + 1);
+            if (i != j)
+                swap_bytes(
+                    PF_OFFSET(items, i * size), PF_OFFSET(items, j * size), size
+                );
+        }
+    }
+}
+
+int vector__shuffle(vector_t *vec, iter_rng_t *rng, size_t size) {
+    if (!vec || !rng || size == 0)
+        return ITER_EINVAL;
+
+    if (vector__unshare(vec))
+        return ITER_ENOMEM;
+
+    shuffle_items(vec->items, vec->length / size, size, rng);
+    return ITER_OK;
+}
+
+/*
+    Sparse array of indexes used by `vector__sample_k`. Indexes that were
+    never swapped map to themselves, so only `O(k)` entries are stored.
+*/
+struct index_map {
+    size_t *keys;
+    size_t *values;
+    size_t mask;
+};
+
+static size_t *index_slot(struct index_map *map, size_t key) {
+    size_t i = (size_t)(key * 0x9E3779B97F4A7C15ull) & map->mask;
+
+    /* keys are stored incremented by one, so that 0 marks empty slots. */
+    while (map->keys[i] && map->keys[i] != key + 1)
+        i = (i + 1) & map->mask;
+
+    return &map->keys[i];
+}
+
+static size_t index_get(struct index_map *map, size_t key) {
+    size_t *slot = index_slot(map, key);
+    return *slot ? map->values[slot - map->keys] : key;
+}
+
+static void index_set(struct index_map *map, size_t key, size_t value) {
+    size_t *slot = index_slot(map, key);
+    *slot = key + 1;
+    map->values[slot - map->keys] = value;
+}
+
+int vector__sample_k(
+    vector_t *dst, const vector_t *src, size_t k, iter_rng_t *rng, size_t size
+) {
+    if (!dst || !src || dst == src || !rng || size == 0
+        || k > src->length / size)
+        return ITER_EINVAL;
+
+    if (k == 0)
+        return ITER_OK;
+
+    if (vector__unshare(dst) || vector__reserve(dst, k * size))
+        return ITER_ENOMEM;
+
+    size_t slots = 16;
+    while (slots < k * 2)
+        slots *= 2;
+
+    allocator_t *allocator = scratch_allocator(dst);
+    size_t *keys = allocate(allocator, slots * sizeof(size_t) * 2);
+    if (!keys)
+        return ITER_ENOMEM;
+
+    memset(keys, 0, slots * sizeof(size_t));
+
+    struct index_map map = { keys, keys + slots, slots - 1 };
+    size_t count = src->length / size;
+    unsigned char *out = vector__end(dst);
+
+    for (size_t i = 0; i < k; i++) {
+        size_t j = i + iter_rng_bounded(rng, count - i);
+        size_t picked = index_get(&map, j);
+
+        index_set(&map, j, index_get(&map, i));
+        memcpy(out + i * size, PF_OFFSET(src->items, picked * size), size);
+    }
+
+    dst->length += k * size;
+    deallocate(allocator, keys, slots * sizeof(size_t) * 2);
+    return ITER_OK;
+}
+
+/* Returns a uniformly distributed number in range `(0, 1]`. */
+static double random_unit(iter_rng_t *rng) {
+    return (double)((iter_rng_next(rng) >> 11) + 1) * 0x1.0p-53;
+}
+
+/*
+    Algorithm L by Kim-Hung Li. `w` is the largest of `k` random numbers
+    assigned to the items in the reservoir, and the gap until the next item
+    with a smaller one is drawn from the geometric distribution it implies.
+*/
+int vector__reservoir_sample(
+    vector_t *dst, iter_t *src, size_t k, iter_rng_t *rng, size_t size
+) {
+    if (!dst || !src || !rng || size == 0)
+        return ITER_EINVAL;
+
+    size_t lower, upper;
+    iter__size_hint(src, &lower, &upper, size);
+    k = PF_MIN(k, upper);
+
+    if (k == 0)
+        return ITER_OK;
+
+    /* replacements are read into one more slot after the reservoir. */
+    if (k >= SIZE_MAX / size || vector__unshare(dst)
+        || vector__reserve(dst, (k + 1) * size))
+        return ITER_ENOMEM;
+
+    unsigned char *reservoir = vector__end(dst);
+    unsigned char *item = reservoir + k * size;
+    size_t count = iter__next_n(src, reservoir, k, size);
+
+    dst->length += count * size;
+    if (count < k)
+        return ITER_OK;
+
+    double w = exp(log(random_unit(rng)) / (double)k);
+
+    for (;;) {
+        double gap = floor(log(random_unit(rng)) / log1p(-w));
+        size_t skip = gap >= 0 && gap < (double)SIZE_MAX ? (size_t)gap
+                                                         : SIZE_MAX;
+
+        if (iter__call(src, item, size, skip))
+            return ITER_OK;
+
+        memcpy(reservoir + iter_rng_bounded(rng, k) * size, item, size);
+        w *= exp(log(random_unit(rng)) / (double)k);
+    }
+}
+
+#define BIT_WORD (sizeof(size_t) * 8)
+
+int vector__apply_permutation(vector_t *vec, const size_t *perm, size_t size) {
+    if (!vec || !perm || size == 0)
+        return ITER_EINVAL;
+
+    size_t count = vec->length / size;
+    if (count < 2)
+        return count == 0 || perm[0] == 0 ? ITER_OK : ITER_EINVAL;
+
+    size_t words = (count + BIT_WORD - 1) / BIT_WORD;
+    size_t bytes = words * sizeof(size_t) + size;
+    allocator_t *allocator = scratch_allocator(vec);
+
+    size_t *visited = allocate(allocator, bytes);
+    if (!visited)
+        return ITER_ENOMEM;
+
+    unsigned char *tmp = (unsigned char *)(visited + words);
+    int status = ITER_OK;
+
+    /* check that every index appears exactly once, before moving items. */
+    memset(visited, 0, words * sizeof(size_t));
+    for (size_t i = 0; i < count && !status; i++) {
+        size_t p = perm[i];
+        size_t bit = (size_t)1 << (p % BIT_WORD);
+
+        if (p >= count || (visited[p / BIT_WORD] & bit))
+            status = ITER_EINVAL;
+        else
+            visited[p / BIT_WORD] |= bit;
+    }
+
+    if (!status && vector__unshare(vec))
+        status = ITER_ENOMEM;
+
+    if (status) {
+        deallocate(allocator, visited, bytes);
+        return status;
+    }
+
+    unsigned char *items = vec->items;
+    memset(visited, 0, words * sizeof(size_t));
+
+    for (size_t start = 0; start < count; start++) {
+        if (visited[start / BIT_WORD] & ((size_t)1 << (start % BIT_WORD)))
+            continue;
+
+        memcpy(tmp, items + start * size, size);
+
+        for (size_t i = start;;) {
+            size_t j = perm[i];
+            visited[i / BIT_WORD] |= (size_t)1 << (i % BIT_WORD);
+
+            if (j == start) {
+                memcpy(items + i * size, tmp, size);
+                break;
+            }
+
+            memcpy(items + i * size, items + j * size, size);
+            i = j;
+        }
+    }
+
+    deallocate(allocator, visited, bytes);
+    return ITER_OK;
+}
+
+/*
+    Parallel shuffle by Sanders: every item is sent to a random bucket and
+    each bucket is then shuffled separately. Buckets are filled by chunks of
+    the input in parallel, using per-chunk counts to find their offsets.
+*/
+struct shuffle_job {
+    unsigned char *items, *buffer;
+    size_t count, size;
+    size_t buckets, chunk;
+    size_t *offsets;
+    size_t *starts;
+    uint64_t *seeds;
+};
+
+static inline size_t chunk_end(const struct shuffle_job *job, size_t c) {
+    return PF_MIN((c + 1) * job->chunk, job->count);
+}
+
+static int count_chunk(size_t c, void *user) {
+    struct shuffle_job *job = user;
+    size_t *counts = job->offsets + c * job->buckets;
+    iter_rng_t rng;
+
+    iter_rng_seed(&rng, job->seeds[c]);
+    for (size_t i = c * job->chunk; i < chunk_end(job, c); i++)
+        counts[iter_rng_bounded(&rng, job->buckets)]++;
+
+    return 0;
+}
+
+static int scatter_chunk(size_t c, void *user) {
+    struct shuffle_job *job = user;
+    size_t *offsets = job->offsets + c * job->buckets;
+    size_t size = job->size;
+    iter_rng_t rng;
+
+    /* the same seed picks the same buckets as `count_chunk`. */
+    iter_rng_seed(&rng, job->seeds[c]);
+    for (size_t i = c * job->chunk; i < chunk_end(job, c); i++) {
+        size_t b = iter_rng_bounded(&rng, job->buckets);
+        memcpy(job->buffer + offsets[b]++ * size, job->items + i * size, size);
+    }
+
+    return 0;
+}
+
+static int shuffle_bucket(size_t b, void *user) {
+    struct shuffle_job *job = user;
+    size_t begin = job->starts[b] * job->size;
+    size_t length = job->starts[b + 1] - job->starts[b];
+    iter_rng_t rng;
+
+    iter_rng_seed(&rng, job->seeds[job->buckets + b]);
+    shuffle_items(job->buffer + begin, length, job->size, &rng);
+    memcpy(job->items + begin, job->buffer + begin, length * job->size);
+    return 0;
+}
+
+int vector__shuffle_parallel(vector_t *vec, iter_rng_t *rng, size_t size) {
+    if (!vec || !rng || size == 0)
+        return ITER_EINVAL;
+
+    size_t buckets = vec->length / SHUFFLE_BUCKET_BYTES;
+    buckets = PF_MIN(buckets, SHUFFLE_MAX_BUCKETS);
+
+    if (buckets < 2)
+        return vector__shuffle(vec, rng, size);
+
+    if (vector__unshare(vec))
+        return ITER_ENOMEM;
+
+    struct shuffle_job job;
+    job.items = vec->items;
+    job.count = vec->length / size;
+    job.size = size;
+    job.buckets = buckets;
+    job.chunk = (job.count + buckets - 1) / buckets;
+
+    /* chunk counts, bucket starts and seeds share a single allocation. */
+    size_t words = buckets * buckets + buckets + 1;
+    size_t seeds = PF_ALIGN_UP(words * sizeof(size_t), alignof(uint64_t));
+    size_t bytes = seeds + buckets * 2 * sizeof(uint64_t);
+    allocator_t *allocator = scratch_allocator(vec);
+
+    job.buffer = allocate(allocator, vec->length);
+    job.offsets = allocate(allocator, bytes);
+
+    if (!job.buffer || !job.offsets) {
+        if (job.buffer)
+            deallocate(allocator, job.buffer, vec->length);
+        if (job.offsets)
+            deallocate(allocator, job.offsets, bytes);
+
+        /* without memory for buckets, shuffle in place. */
+        return vector__shuffle(vec, rng, size);
+    }
+
+    job.starts = job.offsets + buckets * buckets;
+    job.seeds = PF_OFFSET(job.offsets, seeds);
+
+    memset(job.offsets, 0, buckets * buckets * sizeof(size_t));
+    for (size_t i = 0; i < buckets * 2; i++)
+        job.seeds[i] = iter_rng_next(rng);
+
+    parallel_for(buckets, count_chunk, &job);
+
+    /* bucket-major exclusive scan of the per-chunk counts. */
+    size_t offset = 0;
+    for (size_t b = 0; b < buckets; b++) {
+        job.starts[b] = offset;
+
+        for (size_t c = 0; c < buckets; c++) {
+            size_t *slot = &job.offsets[c * buckets + b];
+            size_t n = *slot;
+            *slot = offset;
+            offset += n;
+        }
+    }
+
+    job.starts[buckets] = offset;
+
+    parallel_for(buckets, scatter_chunk, &job);
+    parallel_for(buckets, shuffle_bucket, &job);
+
+    deallocate(allocator, job.buffer, vec->length);
+    deallocate(allocator, job.offsets, bytes);
+    return ITER_OK;
+}
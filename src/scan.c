@@ -0,0 +1,299 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <iter/vector.h>
+#include <pf_macro.h>
+#include <stdint.h>
+#include <string.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/parallel.h>
+
+#include "vector_internal.h"
+
+#if !defined(ITER_NO_SIMD) && defined(__SSE2__)
+    #define SCAN_SSE2
+    #include <emmintrin.h>
+#endif
+
+/* Vectors are scanned in blocks of this size, independently of threads. */
+#define SCAN_BLOCK_BYTES 65536
+
+typedef void(scan_fn)(void *items, size_t count, void *carry, int exclusive);
+typedef void(sum_fn)(const void *items, size_t count, void *out);
+typedef void(add_fn)(void *acc, const void *value);
+
+struct scan_ops {
+    scan_fn *scan;
+    sum_fn *sum;
+    add_fn *add;
+};
+
+/*
+    Integers are added as unsigned, which gives the same bits as two's
+    complement addition of signed integers, without undefined overflow.
+*/
+#define SCAN_SCALAR(m_name, T)                                           \
+    static void m_name##_scan_scalar(                                    \
+        void *items, size_t count, void *carry, int exclusive            \
+    ) {                                                                  \
+        T *x = items, acc;                                               \
+        memcpy(&acc, carry, sizeof(T));                                  \
+        for (size_t i = 0; i < count; i++) {                             \
+            T value = x[i];                                              \
+            x[i] = exclusive ? acc : (T)(acc + value);                   \
+            acc = (T)(acc + value);                                      \
+        }                                                                \
+        memcpy(carry, &acc, sizeof(T));                                  \
+    }                                                                    \
+                                                                         \
+    static void m_name##_sum(const void *items, size_t count, void *out) { \
+        const T *x = items;                                              \
+        T acc = 0;                                                       \
+        for (size_t i = 0; i < count; i++)                               \
+            acc = (T)(acc + x[i]);                                       \
+        memcpy(out, &acc, sizeof(T));                                    \
+    }                                                                    \
+                                                                         \
+    static void m_name##_add(void *acc, const void *value) {             \
+        T l, r;                                                          \
+        memcpy(&l, acc, sizeof(T));                                      \
+        memcpy(&r, value, sizeof(T));                                    \
+        l = (T)(l + r);                                                  \
+        memcpy(acc, &l, sizeof(T));                                      \
+    }
+
+SCAN_SCALAR(u8, uint8_t)
+SCAN_SCALAR(u16, uint16_t)
+SCAN_SCALAR(u32, uint32_t)
+SCAN_SCALAR(u64, uint64_t)
+SCAN_SCALAR(f32, float)
+SCAN_SCALAR(f64, double)
+
+#ifdef SCAN_SSE2
+
+#define SHIFT_PS(m_v, m_n)                                        \
+    _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(m_v), m_n))
+#define SHIFT_PD(m_v, m_n)                                        \
+    _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(m_v), m_n))
+
+/*
+    In-register scans: a block of lanes is scanned with log2(lanes) shifted
+    additions, then the carry of previous blocks is added to every lane and
+    the last lane is broadcast as the next carry.
+*/
+static void u32_scan(void *items, size_t count, void *carry, int exclusive) {
+    uint32_t *x = items, c;
+    memcpy(&c, carry, sizeof(c));
+    __m128i acc = _mm_set1_epi32((int)c);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&x[i]);
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+
+        __m128i out = exclusive ? _mm_slli_si128(v, 4) : v;
+        _mm_storeu_si128((__m128i *)&x[i], _mm_add_epi32(out, acc));
+        acc = _mm_add_epi32(acc, _mm_shuffle_epi32(v, 0xFF));
+    }
+
+    c = (uint32_t)_mm_cvtsi128_si32(acc);
+    memcpy(carry, &c, sizeof(c));
+    u32_scan_scalar(&x[i], count - i, carry, exclusive);
+}
+
+static void u64_scan(void *items, size_t count, void *carry, int exclusive) {
+    uint64_t *x = items, c;
+    memcpy(&c, carry, sizeof(c));
+    __m128i acc = _mm_set_epi64x((int64_t)c, (int64_t)c);
+    size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i *)&x[i]);
+        v = _mm_add_epi64(v, _mm_slli_si128(v, 8));
+
+        __m128i out = exclusive ? _mm_slli_si128(v, 8) : v;
+        _mm_storeu_si128((__m128i *)&x[i], _mm_add_epi64(out, acc));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi64(v, v));
+    }
+
+    _mm_storel_epi64((__m128i *)&c, acc);
+    memcpy(carry, &c, sizeof(c));
+    u64_scan_scalar(&x[i], count - i, carry, exclusive);
+}
+
+static void f32_scan(void *items, size_t count, void *carry, int exclusive) {
+    float *x = items, c;
+    memcpy(&c, carry, sizeof(c));
+    __m128 acc = _mm_set1_ps(c);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(&x[i]);
+        v = _mm_add_ps(v, SHIFT_PS(v, 4));
+        v = _mm_add_ps(v, SHIFT_PS(v, 8));
+
+        __m128 out = exclusive ? SHIFT_PS(v, 4) : v;
+
+        _mm_storeu_ps(&x[i], _mm_add_ps(out, acc));
+        acc = _mm_add_ps(acc, _mm_shuffle_ps(v, v, 0xFF));
+    }
+
+    c = _mm_cvtss_f32(acc);
+    memcpy(carry, &c, sizeof(c));
+    f32_scan_scalar(&x[i], count - i, carry, exclusive);
+}
+
+static void f64_scan(void *items, size_t count, void *carry, int exclusive) {
+    double *x = items, c;
+    memcpy(&c, carry, sizeof(c));
+    __m128d acc = _mm_set1_pd(c);
+    size_t i = 0;
+
+    for (; i + 2 <= count; i += 2) {
+        __m128d v = _mm_loadu_pd(&x[i]);
+        v = _mm_add_pd(v, SHIFT_PD(v, 8));
+
+        __m128d out = exclusive ? SHIFT_PD(v, 8) : v;
+
+        _mm_storeu_pd(&x[i], _mm_add_pd(out, acc));
+        acc = _mm_add_pd(acc, _mm_unpackhi_pd(v, v));
+    }
+
+    c = _mm_cvtsd_f64(acc);
+    memcpy(carry, &c, sizeof(c));
+    f64_scan_scalar(&x[i], count - i, carry, exclusive);
+}
+
+#else
+    #define u32_scan u32_scan_scalar
+    #define u64_scan u64_scan_scalar
+    #define f32_scan f32_scan_scalar
+    #define f64_scan f64_scan_scalar
+#endif
+
+static const struct scan_ops *scan_ops(int is_float, size_t size) {
+    static const struct scan_ops u8 = { u8_scan_scalar, u8_sum, u8_add };
+    static const struct scan_ops u16 = { u16_scan_scalar, u16_sum, u16_add };
+    static const struct scan_ops u32 = { u32_scan, u32_sum, u32_add };
+    static const struct scan_ops u64 = { u64_scan, u64_sum, u64_add };
+    static const struct scan_ops f32 = { f32_scan, f32_sum, f32_add };
+    static const struct scan_ops f64 = { f64_scan, f64_sum, f64_add };
+
+    if (is_float) {
+        if (size == sizeof(float))
+            return &f32;
+        if (size == sizeof(double))
+            return &f64;
+        return NULL;
+    }
+
+    switch (size) {
+    case 1:
+        return &u8;
+    case 2:
+        return &u16;
+    case 4:
+        return &u32;
+    case 8:
+        return &u64;
+    default:
+        return NULL;
+    }
+}
+
+struct scan_job {
+    const struct scan_ops *ops;
+    unsigned char *items;
+    unsigned char *partials;
+    size_t count, block, size;
+    int exclusive;
+};
+
+static inline size_t block_length(const struct scan_job *job, size_t b) {
+    return PF_MIN(job->block, job->count - b * job->block);
+}
+
+static int sum_block(size_t b, void *user) {
+    struct scan_job *job = user;
+    void *items = job->items + b * job->block * job->size;
+
+    job->ops->sum(items, block_length(job, b), job->partials + b * job->size);
+    return 0;
+}
+
+static int scan_block(size_t b, void *user) {
+    struct scan_job *job = user;
+    void *items = job->items + b * job->block * job->size;
+    void *carry = job->partials + b * job->size;
+
+    job->ops->scan(items, block_length(job, b), carry, job->exclusive);
+    return 0;
+}
+
+int vector__scan(
+    vector_t *vec, void *total, int exclusive, int is_float, size_t size
+) {
+    const struct scan_ops *ops = scan_ops(is_float, size);
+
+    if (!vec || !ops)
+        return ITER_EINVAL;
+
+    if (vector__unshare(vec))
+        return ITER_ENOMEM;
+
+    struct scan_job job;
+    job.ops = ops;
+    job.items = vec->items;
+    job.count = vec->length / size;
+    job.block = SCAN_BLOCK_BYTES / size;
+    job.size = size;
+    job.exclusive = exclusive;
+
+    unsigned char carry[sizeof(uint64_t)] = { 0 };
+    size_t blocks = (job.count + job.block - 1) / job.block;
+
+    if (blocks <= 1) {
+        ops->scan(job.items, job.count, carry, exclusive);
+        if (total)
+            memcpy(total, carry, size);
+        return ITER_OK;
+    }
+
+    allocator_t *allocator = scratch_allocator(vec);
+
+    job.partials = allocate(allocator, blocks * size);
+    if (!job.partials)
+        return ITER_ENOMEM;
+
+    /* the sum of the last block is never used as an offset. */
+    parallel_for(blocks - 1, sum_block, &job);
+
+    /* turn the sums into offsets, i.e. an exclusive scan over blocks. */
+    for (size_t b = 0; b + 1 < blocks; b++) {
+        unsigned char *partial = job.partials + b * size;
+        unsigned char sum[sizeof(uint64_t)];
+
+        memcpy(sum, partial, size);
+        memcpy(partial, carry, size);
+        ops->add(carry, sum);
+    }
+
+    memcpy(job.partials + (blocks - 1) * size, carry, size);
+
+    parallel_for(blocks, scan_block, &job);
+
+    if (total)
+        memcpy(total, job.partials + (blocks - 1) * size, size);
+
+    deallocate(allocator, job.partials, blocks * size);
+    return ITER_OK;
+}
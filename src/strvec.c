@@ -0,0 +1,283 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <iter/iter.h>
+#include <iter/vector.h>
+#include <pf_macro.h>
+#include <stdint.h>
+#include <string.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/strvec.h>
+
+extern allocator_t *libiter_allocator;
+
+#define STRVEC_INSERTION_SORT 16
+
+struct strvec_iter {
+    const strvec_t *sv;
+    size_t index;
+};
+
+ITER__ASSERT_FITS(struct strvec_iter);
+
+static inline strvec_span_t *spans(const strvec_t *sv) {
+    return sv->spans.items;
+}
+
+strvec_t *strvec_init(strvec_t *out, allocator_t *allocator) {
+    if (out) {
+        vector__init(&out->bytes, allocator);
+        vector__init(&out->spans, allocator);
+    }
+
+    return out;
+}
+
+void strvec_free(strvec_t *sv) {
+    if (sv) {
+        vector__free(&sv->bytes);
+        vector__free(&sv->spans);
+    }
+}
+
+strvec_t *strvec_create(allocator_t *allocator) {
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    return strvec_init(allocate(allocator, sizeof(strvec_t)), allocator);
+}
+
+void strvec_destroy(strvec_t *sv) {
+    if (sv) {
+        strvec_free(sv);
+        deallocate(sv->spans.allocator, sv, sizeof(strvec_t));
+    }
+}
+
+int strvec_reserve(strvec_t *sv, size_t count, size_t bytes) {
+    if (!sv || count == 0 || count > SIZE_MAX / sizeof(strvec_span_t)
+        || bytes > SIZE_MAX - count)
+        return ITER_EINVAL;
+
+    /* spans are 32-bit, so the blob can't grow past STRVEC_MAX_BYTES. */
+    if (bytes + count > STRVEC_MAX_BYTES - sv->bytes.length)
+        return ITER_ENOMEM;
+
+    if (vector__reserve(&sv->spans, count * sizeof(strvec_span_t))
+        || vector__reserve(&sv->bytes, bytes + count))
+        return ITER_ENOMEM;
+
+    return ITER_OK;
+}
+
+/* Appends a string, space for it must be reserved beforehand. */
+static void push_reserved(strvec_t *sv, const char *str, size_t length) {
+    strvec_span_t *span = vector__end(&sv->spans);
+    char *dst = vector__end(&sv->bytes);
+
+    span->offset = (uint32_t)sv->bytes.length;
+    span->length = (uint32_t)length;
+    memcpy(dst, str, length);
+    dst[length] = '\0';
+
+    sv->bytes.length += length + 1;
+    sv->spans.length += sizeof(strvec_span_t);
+}
+
+int strvec_push(strvec_t *sv, const char *str, size_t length) {
+    if (!sv || (!str && length > 0))
+        return ITER_EINVAL;
+
+    int status = strvec_reserve(sv, 1, length);
+    if (status)
+        return status;
+
+    push_reserved(sv, str ? str : "", length);
+    return ITER_OK;
+}
+
+const char *strvec_get(const strvec_t *sv, size_t i, size_t *length) {
+    if (!sv || i >= strvec_length(sv))
+        return NULL;
+
+    const strvec_span_t *span = &spans(sv)[i];
+    if (length)
+        *length = span->length;
+
+    return PF_OFFSET(sv->bytes.items, span->offset);
+}
+
+int strvec_load_lines(strvec_t *sv, const char *buffer, size_t size) {
+    if (!sv || (!buffer && size > 0))
+        return ITER_EINVAL;
+
+    const char *end = buffer + size;
+    size_t count = 0;
+
+    for (const char *p = buffer; p < end; count++) {
+        const char *nl = memchr(p, '\n', end - p);
+        p = nl ? nl + 1 : end;
+    }
+
+    if (count == 0)
+        return ITER_OK;
+
+    int status = strvec_reserve(sv, count, size);
+    if (status)
+        return status;
+
+    for (const char *p = buffer; p < end;) {
+        const char *nl = memchr(p, '\n', end - p);
+        const char *eol = nl ? nl : end;
+
+        push_reserved(sv, p, eol - p);
+        p = nl ? nl + 1 : end;
+    }
+
+    return ITER_OK;
+}
+
+struct sorter {
+    const char *bytes;
+    strvec_compare_fn *compare;
+};
+
+static inline int span_compare(
+    const struct sorter *s, const strvec_span_t *lhs, const strvec_span_t *rhs
+) {
+    const char *l = s->bytes + lhs->offset, *r = s->bytes + rhs->offset;
+
+    if (s->compare)
+        return s->compare(l, lhs->length, r, rhs->length);
+
+    int diff = memcmp(l, r, PF_MIN(lhs->length, rhs->length));
+    if (diff)
+        return diff;
+
+    return (lhs->length > rhs->length) - (lhs->length < rhs->length);
+}
+
+static void insertion_sort(
+    const struct sorter *s, strvec_span_t *items, size_t count
+) {
+    for (size_t i = 1; i < count; i++) {
+        strvec_span_t key = items[i];
+        size_t j = i;
+
+        for (; j > 0 && span_compare(s, &items[j - 1], &key) > 0; j--)
+            items[j] = items[j - 1];
+
+        items[j] = key;
+    }
+}
+
+/* Sorts `items` using `tmp`, which must have space for `count` spans. */
+static void merge_sort(
+    const struct sorter *s,
+    strvec_span_t *items,
+    strvec_span_t *tmp,
+    size_t count
+) {
+    if (count <= STRVEC_INSERTION_SORT) {
+        insertion_sort(s, items, count);
+        return;
+    }
+
+    size_t half = count / 2;
+    merge_sort(s, items, tmp, half);
+    merge_sort(s, items + half, tmp, count - half);
+
+    /* already in order, e.g. when sorting sorted input. */
+    if (span_compare(s, &items[half - 1], &items[half]) <= 0)
+        return;
+
+    memcpy(tmp, items, half * sizeof(strvec_span_t));
+
+    size_t i = 0, j = half, k = 0;
+    while (i < half && j < count) {
+        if (span_compare(s, &items[j], &tmp[i]) < 0)
+            items[k++] = items[j++];
+        else
+            items[k++] = tmp[i++];
+    }
+
+    memcpy(&items[k], &tmp[i], (half - i) * sizeof(strvec_span_t));
+}
+
+int strvec_sort(strvec_t *sv, strvec_compare_fn *compare) {
+    if (!sv)
+        return ITER_EINVAL;
+
+    size_t count = strvec_length(sv);
+    if (count < 2)
+        return ITER_OK;
+
+    struct sorter s = { sv->bytes.items, compare };
+    strvec_span_t *tmp = NULL;
+    size_t tmp_size = (count / 2) * sizeof(strvec_span_t);
+
+    if (count > STRVEC_INSERTION_SORT) {
+        tmp = allocate(sv->spans.allocator, tmp_size);
+        if (!tmp)
+            return ITER_ENOMEM;
+    }
+
+    merge_sort(&s, spans(sv), tmp, count);
+
+    if (tmp)
+        deallocate(sv->spans.allocator, tmp, tmp_size);
+
+    return ITER_OK;
+}
+
+static int strvec_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (!it || size != sizeof(strvec_item_t))
+        return ITER_EINVAL;
+
+    if (it == out)
+        return ITER_OK;
+
+    struct strvec_iter *sit = ITER__CAST(it);
+    size_t length = strvec_length(sit->sv);
+
+    if (skip) {
+        if (skip >= length - PF_MIN(sit->index, length)) {
+            sit->index = length;
+            return ITER_ENODATA;
+        }
+
+        sit->index += skip;
+    }
+
+    if (out) {
+        if (sit->index >= length)
+            return ITER_ENODATA;
+
+        strvec_item_t *item = out;
+        item->str = strvec_get(sit->sv, sit->index, &item->length);
+        sit->index++;
+    }
+
+    return ITER_OK;
+}
+
+iter(strvec_item_t) strvec_iter(const strvec_t *sv, iter_t *out) {
+    if (!sv || !out)
+        return NULL;
+
+    struct strvec_iter *sit = ITER__CAST(out);
+    sit->sv = sv;
+    sit->index = 0;
+    out->call = strvec_iter_fn;
+    out->ops = NULL;
+
+    return (iter(strvec_item_t))out;
+}
@@ -7,20 +7,186 @@
 
 #include <allocator.h>
 #include <iter/error.h>
+#include <iter/hash.h>
 #include <iter/iter.h>
+#include <pf_bitwise.h>
 #include <pf_macro.h>
+#include <stdint.h>
 #include <string.h>
 
 #undef ITER_API
 #define ITER_API
 #include <iter/vector.h>
 
+#include "vector_internal.h"
+
 extern allocator_t *libiter_allocator;
+extern hasher_fn *libiter_hasher;
+
+#if !defined(ITER_NO_SIMD) && defined(__SSE2__)
+    #define VECTOR_SSE2
+    #include <emmintrin.h>
+#endif
 
 #define VECTOR_GROWTH(old, req) ((old + req) * 1.5)
 
 #define SORT_BUFFER_SIZE 4096
 
+/*
+    Buffers of vectors with an explicit alignment are over-allocated by
+    `align + sizeof(size_t)` bytes. The distance from the start of the
+    allocation to the aligned items is stored right before the items.
+*/
+static inline size_t aligned_extra(size_t align) {
+    return align ? align + sizeof(size_t) : 0;
+}
+
+static inline size_t aligned_pad(const void *items) {
+    size_t pad;
+    memcpy(&pad, PF_OFFSET(items, -(ptrdiff_t)sizeof(size_t)), sizeof(pad));
+    return pad;
+}
+
+static void *aligned_reallocate(
+    allocator_t *allocator,
+    void *items,
+    size_t old_capacity,
+    size_t capacity,
+    size_t align
+) {
+    if (!align)
+        return reallocate(allocator, items, old_capacity, capacity);
+
+    size_t extra = aligned_extra(align), pad = 0;
+    unsigned char *raw = NULL;
+
+    if (items) {
+        pad = aligned_pad(items);
+        raw = PF_OFFSET(items, -(ptrdiff_t)pad);
+    }
+
+    if (capacity == 0) {
+        if (raw)
+            deallocate(allocator, raw, old_capacity + extra);
+        return NULL;
+    }
+
+    if (capacity > SIZE_MAX - extra)
+        return NULL;
+
+    raw = reallocate(
+        allocator, raw, raw ? old_capacity + extra : 0, capacity + extra
+    );
+
+    if (!raw)
+        return NULL;
+
+    uintptr_t base = (uintptr_t)raw + sizeof(size_t);
+    size_t new_pad = sizeof(size_t) + (-base & (align - 1));
+    void *out = raw + new_pad;
+
+    if (items && new_pad != pad)
+        memmove(out, raw + pad, PF_MIN(old_capacity, capacity));
+
+    memcpy(raw + new_pad - sizeof(size_t), &new_pad, sizeof(new_pad));
+    return out;
+}
+
+static inline void *aligned_allocate(
+    allocator_t *allocator, size_t capacity, size_t align
+) {
+    return aligned_reallocate(allocator, NULL, 0, capacity, align);
+}
+
+static inline void aligned_deallocate(
+    allocator_t *allocator, void *items, size_t capacity, size_t align
+) {
+    if (align)
+        aligned_reallocate(allocator, items, capacity, 0, align);
+    else
+        deallocate(allocator, items, capacity);
+}
+
+/*
+    Buffer shared between a vector and its slices. It's created the first time
+    a vector is sliced and it's freed, together with the buffer, once the last
+    vector referencing it has been destroyed or has copied its items.
+*/
+struct vector_buffer {
+    size_t refs;
+    void *items;
+    size_t capacity;
+    size_t align;
+    allocator_t *allocator;
+    allocator_t *owner;
+};
+
+static void buffer_release(struct vector_buffer *buf) {
+    if (__atomic_sub_fetch(&buf->refs, 1, __ATOMIC_ACQ_REL) > 0)
+        return;
+
+    if (buf->allocator)
+        aligned_deallocate(
+            buf->allocator, buf->items, buf->capacity, buf->align
+        );
+
+    deallocate(buf->owner, buf, sizeof(struct vector_buffer));
+}
+
+static void release_items(vector_t *vec) {
+    if (vec->shared)
+        buffer_release(vec->shared);
+    else if (vec->allocator && vec->items)
+        aligned_deallocate(
+            vec->allocator, vec->items, vec->capacity, vec->align
+        );
+
+    vec->shared = NULL;
+    vec->items = NULL;
+    vec->length = vec->capacity = 0;
+}
+
+/*
+    Gives `vec` its own buffer with space for `capacity` bytes. If no other
+    vector references the shared buffer, it's taken over without copying.
+*/
+static int detach(vector_t *vec, size_t capacity) {
+    struct vector_buffer *buf = vec->shared;
+    size_t length = PF_MIN(vec->length, capacity);
+
+    if (__atomic_load_n(&buf->refs, __ATOMIC_ACQUIRE) == 1
+        && buf->allocator == vec->allocator && buf->align == vec->align
+        && buf->capacity >= capacity) {
+        if (vec->items != buf->items)
+            memmove(buf->items, vec->items, length);
+
+        vec->items = buf->items;
+        vec->capacity = buf->capacity;
+        vec->length = length;
+        vec->shared = NULL;
+        deallocate(buf->owner, buf, sizeof(struct vector_buffer));
+        return ITER_OK;
+    }
+
+    allocator_t *allocator = scratch_allocator(vec);
+    void *items = NULL;
+
+    if (capacity > 0
+        && !(items = aligned_allocate(allocator, capacity, vec->align)))
+        return ITER_ENOMEM;
+
+    if (length > 0)
+        memcpy(items, vec->items, length);
+
+    buffer_release(buf);
+    vec->shared = NULL;
+    vec->allocator = allocator;
+    vec->items = items;
+    vec->capacity = capacity;
+    vec->length = length;
+    return ITER_OK;
+}
+
 vector_t *vector__init(vector_t *vec, allocator_t *allocator) {
     if (!allocator)
         allocator = libiter_allocator;
@@ -29,6 +195,8 @@ vector_t *vector__init(vector_t *vec, allocator_t *allocator) {
         vec->length = vec->capacity = 0;
         vec->items = NULL;
         vec->allocator = allocator;
+        vec->shared = NULL;
+        vec->align = 0;
     }
 
     return vec;
@@ -42,6 +210,25 @@ vector_t *vector__create(allocator_t *allocator) {
     return vector__init(vec, allocator);
 }
 
+vector_t *vector__with_alignment(
+    size_t cap, size_t align, allocator_t *allocator
+) {
+    if (align == 0 || (align & (align - 1)) != 0)
+        return NULL;
+
+    vector_t *out = vector__create(allocator);
+    if (!out)
+        return NULL;
+
+    out->align = align;
+    if (cap > 0 && vector__reserve(out, cap)) {
+        vector__destroy(out);
+        return NULL;
+    }
+
+    return out;
+}
+
 vector_t *vector__with_capacity(size_t cap, allocator_t *allocator) {
     vector_t *out = vector__create(allocator);
 
@@ -71,15 +258,17 @@ vector_t *vector__from_array(
 
 void vector__destroy(vector_t *vec) {
     if (vec) {
-        if (vec->allocator)
-            deallocate(vec->allocator, vec->items, vec->capacity);
-
-        vector__unwrap(vec);
+        release_items(vec);
+        deallocate(
+            vec->allocator ? vec->allocator : libiter_allocator,
+            vec,
+            sizeof(vector_t)
+        );
     }
 }
 
 void *vector__unwrap(vector_t *vec) {
-    if (!vec)
+    if (!vec || vec->align || vector__unshare(vec))
         return NULL;
 
     void *items = vec->items;
@@ -107,12 +296,57 @@ vector_t *vector__wrap(void *items, size_t length, allocator_t *allocator) {
     return vec;
 }
 
+vector_t *vector__slice(vector_t *vec, size_t from, size_t to) {
+    if (!vec || from > to || to > vec->length)
+        return NULL;
+
+    vector_t *out = vector__create(vec->allocator);
+    if (!out || from == to)
+        return out;
+
+    struct vector_buffer *buf = vec->shared;
+    if (!buf) {
+        allocator_t *owner = scratch_allocator(vec);
+
+        buf = allocate(owner, sizeof(struct vector_buffer));
+        if (!buf) {
+            vector__destroy(out);
+            return NULL;
+        }
+
+        buf->refs = 1;
+        buf->items = vec->items;
+        buf->capacity = vec->capacity;
+        buf->align = vec->align;
+        buf->allocator = vec->allocator;
+        buf->owner = owner;
+        vec->shared = buf;
+    }
+
+    __atomic_add_fetch(&buf->refs, 1, __ATOMIC_RELAXED);
+    out->allocator = vec->allocator;
+    out->shared = buf;
+    out->items = PF_OFFSET(vec->items, from);
+    out->length = out->capacity = to - from;
+    return out;
+}
+
+int vector__unshare(vector_t *vec) {
+    if (!vec)
+        return ITER_EINVAL;
+
+    return vec->shared ? detach(vec, vec->length) : ITER_OK;
+}
+
 int vector__resize(vector_t *vec, size_t capacity) {
-    if (!vec || !vec->allocator)
+    if (!vec || (!vec->allocator && !vec->shared))
         return ITER_EINVAL;
 
-    void *items = reallocate(
-        vec->allocator, vec->items, vec->capacity, capacity
+    if (vec->shared)
+        return detach(vec, capacity);
+
+    void *items = aligned_reallocate(
+        vec->allocator, vec->items, vec->capacity, capacity, vec->align
     );
 
     if (!items && capacity > 0)
@@ -140,13 +374,16 @@ int vector__insert(vector_t *vec, const void *items, size_t i, size_t size) {
     if (!vec || !items || size == 0 || i > vec->length)
         return ITER_EINVAL;
 
+    if (vector__unshare(vec))
+        return ITER_ENOMEM;
+
     if (vector__reserve(vec, size))
         return ITER_ENOMEM;
 
     if (i < vec->length) {
         void *dst = vector__slot(vec, i + size);
         void *src = vector__slot(vec, i);
-        memcpy(dst, src, vec->length - i);
+        memmove(dst, src, vec->length - i);
     }
 
     vec->length += size;
@@ -158,14 +395,20 @@ int vector__remove(vector_t *vec, size_t i, size_t size) {
     if (!vec || size == 0 || i + size > vec->length)
         return ITER_EINVAL;
 
-    if (i + size < vec->length - 1) {
-        memcpy(
-            vector__slot(vec, i),
-            vector__slot(vec, i + size),
-            vec->length - i - size
-        );
+    if (i + size == vec->length) {
+        vec->length -= size;
+        return ITER_OK;
     }
 
+    if (vector__unshare(vec))
+        return ITER_ENOMEM;
+
+    memmove(
+        vector__slot(vec, i),
+        vector__slot(vec, i + size),
+        vec->length - i - size
+    );
+
     vec->length -= size;
     return ITER_OK;
 }
@@ -175,6 +418,9 @@ int vector__swap_remove(vector_t *vec, size_t i, size_t size) {
         return ITER_EINVAL;
 
     if (i + size < vec->length) {
+        if (vector__unshare(vec))
+            return ITER_ENOMEM;
+
         memcpy(
             vector__slot(vec, i), vector__slot(vec, vec->length - size), size
         );
@@ -189,19 +435,16 @@ int vector__swap(vector_t *vec, size_t i, size_t j, size_t size) {
         || (i >= j && i < j + size) || (j >= i && j < i + size))
         return ITER_EINVAL;
 
-    if (vector__reserve(vec, size))
+    if (vector__unshare(vec))
         return ITER_ENOMEM;
 
-    memcpy(vector__slot(vec, vec->length), vector__slot(vec, i), size);
-    memcpy(vector__slot(vec, i), vector__slot(vec, j), size);
-    memcpy(vector__slot(vec, j), vector__slot(vec, vec->length), size);
+    swap_bytes(vector__slot(vec, i), vector__slot(vec, j), size);
     return ITER_OK;
 }
 
 void vector__free(vector_t *vec) {
-    if (vec && vec->items) {
-        deallocate(vec->allocator, vec->items, vec->capacity);
-    }
+    if (vec)
+        release_items(vec);
 }
 
 size_t vector__index(const vector_t *vec, const void *item) {
@@ -218,6 +461,9 @@ int vector__each(vector_t *vec, vector_each_fn *each, void *user, size_t size) {
     if (!vec || !each || size == 0)
         return ITER_EINVAL;
 
+    if (vector__unshare(vec))
+        return ITER_ENOMEM;
+
     for (size_t i = 0; i < vec->length; i += size)
         if (each(vector__slot(vec, i), user))
             return ITER_EINTR;
@@ -231,6 +477,9 @@ int vector__filter(
     if (!vec || !filter || size == 0)
         return ITER_EINVAL;
 
+    if (vector__unshare(vec))
+        return ITER_ENOMEM;
+
     for (size_t i = 0; i < vec->length; i += size) {
         if (!filter(vector__slot(vec, i), user)) {
             vector__remove(vec, i, size);
@@ -253,7 +502,7 @@ int vector__map(
         return ITER_EINVAL;
 
     size_t count = src->length / ssize;
-    if (vector__reserve(dst, count * dsize))
+    if (vector__unshare(dst) || vector__reserve(dst, count * dsize))
         return ITER_ENOMEM;
 
     for (size_t i = 0; i < count; i++) {
@@ -300,12 +549,22 @@ vector_t *vector__from_iter(iter_t *it, allocator_t *allocator, size_t stride) {
     if (!it || stride == 0)
         return NULL;
 
-    vector_t *out = vector__with_capacity(stride, allocator);
-    if (out) {
-        while (!iter__call(it, vector__end(out), stride, 0)) {
-            out->length += stride;
+    size_t lower, upper;
+    iter__size_hint(it, &lower, &upper, stride);
 
-            if (vector__reserve(out, stride))
+    /* exact hints are reserved at once, so the loop below never grows. */
+    size_t cap = lower > 0 && lower <= SIZE_MAX / stride ? lower : 1;
+
+    vector_t *out = vector__with_capacity(cap * stride, allocator);
+    if (out) {
+        /* fill the spare capacity in batches, until the iterator runs out. */
+        for (;;) {
+            size_t spare = (out->capacity - out->length) / stride;
+            size_t count = iter__next_n(it, vector__end(out), spare, stride);
+            out->length += count * stride;
+
+            if (count < spare || out->length / stride >= upper
+                || vector__reserve(out, stride))
                 break;
         }
     }
@@ -313,86 +572,298 @@ vector_t *vector__from_iter(iter_t *it, allocator_t *allocator, size_t stride) {
     return out;
 }
 
+#define SORT_INSERTION 16
+
+/*
+    Stable merge sort that uses whatever scratch space it is given. Merges
+    whose shorter run fits into the scratch buffer are done by copying, while
+    larger ones are split with SymMerge and rotations, so that the sort works
+    in place when no scratch space is available.
+*/
 struct sorter {
-    void *A, *B;
-    size_t count, size;
-    size_t left, right, end;
+    unsigned char *items;
+    unsigned char *buffer;
+    size_t buffer_items;
+    size_t size;
     vector_compare_fn *compare;
 };
 
-static int mergesort_compare(struct sorter *s, size_t i, size_t j) {
-    if (i >= s->right || j >= s->end)
-        return i < s->right ? -1 : 0;
+static inline void *sort_at(const struct sorter *s, size_t i) {
+    return s->items + i * s->size;
+}
 
-    return s->compare(
-        PF_OFFSET(s->A, i * s->size), PF_OFFSET(s->A, j * s->size), s->size
-    );
+static inline int sort_less(const struct sorter *s, size_t i, size_t j) {
+    return s->compare(sort_at(s, i), sort_at(s, j), s->size) < 0;
 }
 
-static void mergesort_copy(struct sorter *s, size_t dst, size_t src) {
-    memcpy(
-        PF_OFFSET(s->B, dst * s->size), PF_OFFSET(s->A, src * s->size), s->size
-    );
+static void sort_swap(const struct sorter *s, size_t i, size_t j) {
+    swap_bytes(sort_at(s, i), sort_at(s, j), s->size);
 }
 
-static void mergesort_merge(struct sorter *s) {
-    size_t i = s->left, j = s->right;
+static void sort_reverse(const struct sorter *s, size_t a, size_t b) {
+    for (; a + 1 < b; a++, b--)
+        sort_swap(s, a, b - 1);
+}
 
-    for (size_t k = s->left; k < s->end; k++) {
-        if (mergesort_compare(s, i, j) < 0) {
-            mergesort_copy(s, k, i);
-            i = i + 1;
-        } else {
-            mergesort_copy(s, k, j);
-            j = j + 1;
-        }
+/* Swaps ranges `[a, m)` and `[m, b)`. */
+static void sort_rotate(const struct sorter *s, size_t a, size_t m, size_t b) {
+    size_t left = m - a, right = b - m;
+
+    if (left <= s->buffer_items) {
+        memcpy(s->buffer, sort_at(s, a), left * s->size);
+        memmove(sort_at(s, a), sort_at(s, m), right * s->size);
+        memcpy(sort_at(s, a + right), s->buffer, left * s->size);
+    } else if (right <= s->buffer_items) {
+        memcpy(s->buffer, sort_at(s, m), right * s->size);
+        memmove(sort_at(s, a + right), sort_at(s, a), left * s->size);
+        memcpy(sort_at(s, a), s->buffer, right * s->size);
+    } else {
+        sort_reverse(s, a, m);
+        sort_reverse(s, m, b);
+        sort_reverse(s, a, b);
+    }
+}
+
+/* Merges runs `[a, m)` and `[m, b)`, copying the left one to the buffer. */
+static void merge_lo(const struct sorter *s, size_t a, size_t m, size_t b) {
+    size_t left = m - a, i = 0, j = m, k = a;
+    size_t size = s->size;
+
+    memcpy(s->buffer, sort_at(s, a), left * size);
+
+    while (i < left && j < b) {
+        if (s->compare(sort_at(s, j), s->buffer + i * size, size) < 0)
+            memcpy(sort_at(s, k++), sort_at(s, j++), size);
+        else
+            memcpy(sort_at(s, k++), s->buffer + i++ * size, size);
     }
+
+    memcpy(sort_at(s, k), s->buffer + i * size, (left - i) * size);
 }
 
-static void *mergesort(struct sorter *s) {
-    for (size_t w = 1; w < s->count; w *= 2) {
-        for (size_t i = 0; i < s->count; i = i + 2 * w) {
-            s->left = i;
-            s->right = PF_MIN(i + w, s->count);
-            s->end = PF_MIN(i + 2 * w, s->count);
-            mergesort_merge(s);
+/* Merges runs `[a, m)` and `[m, b)`, copying the right one to the buffer. */
+static void merge_hi(const struct sorter *s, size_t a, size_t m, size_t b) {
+    size_t right = b - m, i = m, j = right, k = b;
+    size_t size = s->size;
+
+    memcpy(s->buffer, sort_at(s, m), right * size);
+
+    while (i > a && j > 0) {
+        if (s->compare(s->buffer + (j - 1) * size, sort_at(s, i - 1), size) < 0)
+            memcpy(sort_at(s, --k), sort_at(s, --i), size);
+        else
+            memcpy(sort_at(s, --k), s->buffer + --j * size, size);
+    }
+
+    memcpy(sort_at(s, a), s->buffer, j * size);
+}
+
+static void merge(const struct sorter *s, size_t a, size_t m, size_t b);
+
+/*
+    SymMerge by Kim and Kutzner, as used by Go's `sort.Stable`. It splits
+    both runs around a rotation, so that the halves can be merged separately.
+*/
+static void sym_merge(const struct sorter *s, size_t a, size_t m, size_t b) {
+    if (m - a == 1) {
+        size_t i = m, j = b;
+        while (i < j) {
+            size_t h = i + (j - i) / 2;
+            if (sort_less(s, h, a))
+                i = h + 1;
+            else
+                j = h;
+        }
+
+        sort_rotate(s, a, m, i);
+        return;
+    }
+
+    if (b - m == 1) {
+        size_t i = a, j = m;
+        while (i < j) {
+            size_t h = i + (j - i) / 2;
+            if (!sort_less(s, m, h))
+                i = h + 1;
+            else
+                j = h;
         }
 
-        PF_SWAP(s->A, s->B);
+        sort_rotate(s, i, m, b);
+        return;
+    }
+
+    size_t mid = a + (b - a) / 2;
+    size_t n = mid + m;
+    size_t start, r;
+
+    if (m > mid) {
+        start = n - b;
+        r = mid;
+    } else {
+        start = a;
+        r = m;
+    }
+
+    for (size_t p = n - 1; start < r;) {
+        size_t c = start + (r - start) / 2;
+        if (!sort_less(s, p - c, c))
+            start = c + 1;
+        else
+            r = c;
     }
 
-    return s->A;
+    size_t end = n - start;
+    if (start < m && m < end)
+        sort_rotate(s, start, m, end);
+
+    merge(s, a, start, mid);
+    merge(s, mid, end, b);
 }
 
-int vector__sort(vector_t *vec, vector_compare_fn *compare, size_t size) {
-    if (!vec || size == 0 || !compare)
+static void merge(const struct sorter *s, size_t a, size_t m, size_t b) {
+    if (a >= m || m >= b || !sort_less(s, m, m - 1))
+        return;
+
+    size_t left = m - a, right = b - m;
+
+    if (left <= right && left <= s->buffer_items)
+        merge_lo(s, a, m, b);
+    else if (right <= s->buffer_items)
+        merge_hi(s, a, m, b);
+    else if (left <= s->buffer_items)
+        merge_lo(s, a, m, b);
+    else
+        sym_merge(s, a, m, b);
+}
+
+static void insertion_sort(const struct sorter *s, size_t a, size_t b) {
+    for (size_t i = a + 1; i < b; i++)
+        for (size_t j = i; j > a && sort_less(s, j, j - 1); j--)
+            sort_swap(s, j, j - 1);
+}
+
+static void sort(struct sorter *s, size_t count) {
+    for (size_t i = 0; i < count; i += SORT_INSERTION)
+        insertion_sort(s, i, PF_MIN(i + SORT_INSERTION, count));
+
+    for (size_t w = SORT_INSERTION; w < count; w *= 2)
+        for (size_t i = 0; i + w < count; i += 2 * w)
+            merge(s, i, i + w, PF_MIN(i + 2 * w, count));
+}
+
+int vector__sort_with_buffer(
+    vector_t *vec,
+    vector_compare_fn *compare,
+    void *buffer,
+    size_t length,
+    size_t size
+) {
+    if (!vec || size == 0 || !compare || (!buffer && length > 0))
         return ITER_EINVAL;
 
     if (vec->length < size * 2)
         return ITER_OK;
 
-    char buffer[SORT_BUFFER_SIZE];
+    if (vector__unshare(vec))
+        return ITER_ENOMEM;
 
     struct sorter s;
-    s.A = vec->items;
-    s.B = buffer;
-    s.count = vec->length / size;
+    s.items = vec->items;
+    s.buffer = buffer;
+    s.buffer_items = length / size;
     s.size = size;
     s.compare = compare;
 
-    if (vec->length > SORT_BUFFER_SIZE)
-        s.B = allocate(libiter_allocator, vec->length);
+    sort(&s, vec->length / size);
+    return ITER_OK;
+}
+
+int vector__sort(vector_t *vec, vector_compare_fn *compare, size_t size) {
+    if (!vec || size == 0 || !compare)
+        return ITER_EINVAL;
+
+    /* merges never need more than half of the items in the buffer. */
+    size_t length = (vec->length / size + 1) / 2 * size;
+    char stack[SORT_BUFFER_SIZE];
+
+    if (length <= SORT_BUFFER_SIZE)
+        return vector__sort_with_buffer(vec, compare, stack, length, size);
+
+    allocator_t *allocator = scratch_allocator(vec);
+    void *buffer = allocate(allocator, length);
+
+    /* without memory, sort in place with the smaller buffer. */
+    if (!buffer)
+        return vector__sort_with_buffer(
+            vec, compare, stack, SORT_BUFFER_SIZE, size
+        );
+
+    int status = vector__sort_with_buffer(vec, compare, buffer, length, size);
+    deallocate(allocator, buffer, length);
+    return status;
+}
+
+/* Items read at once while selecting the top items. */
+#define TOP_K_BATCH 64
+
+/* Restores the max-heap of `[0, count)` below `i`. */
+static void heap_sift_down(const struct sorter *s, size_t i, size_t count) {
+    for (size_t child; (child = 2 * i + 1) < count; i = child) {
+        if (child + 1 < count && sort_less(s, child, child + 1))
+            child++;
+
+        if (!sort_less(s, i, child))
+            break;
+
+        sort_swap(s, i, child);
+    }
+}
+
+int vector__top_k(
+    vector_t *dst, iter_t *src, size_t k, vector_compare_fn *cmp, size_t size
+) {
+    if (!dst || !src || !cmp || size == 0)
+        return ITER_EINVAL;
+
+    size_t lower, upper;
+    iter__size_hint(src, &lower, &upper, size);
+    k = PF_MIN(k, upper);
 
-    if (s.B == NULL)
+    if (k == 0)
+        return ITER_OK;
+
+    /* the batch of candidates is read right after the heap. */
+    if (k > SIZE_MAX / size - TOP_K_BATCH || vector__unshare(dst)
+        || vector__reserve(dst, (k + TOP_K_BATCH) * size))
         return ITER_ENOMEM;
 
-    void *out = mergesort(&s);
+    struct sorter s = { vector__end(dst), NULL, 0, size, cmp };
+    size_t count = iter__next_n(src, s.items, k, size);
+
+    for (size_t i = count / 2; i > 0; i--)
+        heap_sift_down(&s, i - 1, count);
+
+    unsigned char *batch = sort_at(&s, k);
+    size_t n = count < k ? 0 : TOP_K_BATCH;
 
-    if (out != vec->items)
-        memcpy(vec->items, out, vec->length);
+    while (n == TOP_K_BATCH) {
+        n = iter__next_n(src, batch, TOP_K_BATCH, size);
 
-    if (vec->length > SORT_BUFFER_SIZE)
-        deallocate(libiter_allocator, s.B, vec->length);
+        for (size_t i = 0; i < n; i++) {
+            if (cmp(&batch[i * size], s.items, size) < 0) {
+                memcpy(s.items, &batch[i * size], size);
+                heap_sift_down(&s, 0, k);
+            }
+        }
+    }
+
+    for (size_t end = count; end > 1; end--) {
+        sort_swap(&s, 0, end - 1);
+        heap_sift_down(&s, 0, end - 1);
+    }
+
+    dst->length += count * size;
     return ITER_OK;
 }
 
@@ -406,3 +877,139 @@ int vector__is_sorted(vector_t *v, vector_compare_fn *compare, size_t size) {
 
     return ITER_TRUE;
 }
+
+#ifdef VECTOR_SSE2
+static inline int unique_block_equal(__m128i x, __m128i y, size_t size) {
+    __m128i eq;
+
+    switch (size) {
+    case 1: eq = _mm_cmpeq_epi8(x, y); break;
+    case 2: eq = _mm_cmpeq_epi16(x, y); break;
+    case 4: eq = _mm_cmpeq_epi32(x, y); break;
+    default:
+        /* SSE2 lacks 64-bit comparison, both halves must be equal. */
+        eq = _mm_cmpeq_epi32(x, y);
+        y = _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1));
+        eq = _mm_and_si128(eq, y);
+        break;
+    }
+
+    return _mm_movemask_epi8(eq) != 0;
+}
+
+/*
+    Compares 16 bytes of items with the same bytes shifted by one item.
+    Blocks without duplicates are moved with a single store, the first block
+    with a duplicate is left for the scalar loop. Returns the read offset,
+    while `*w` is updated to the write offset.
+*/
+static size_t unique_sse2(
+    unsigned char *items, size_t length, size_t size, size_t r, size_t *w
+) {
+    while (r + 16 <= length) {
+        __m128i cur = _mm_loadu_si128((const __m128i *)&items[r]);
+        __m128i prev = _mm_loadu_si128((const __m128i *)&items[r - size]);
+
+        if (unique_block_equal(cur, prev, size))
+            break;
+
+        _mm_storeu_si128((__m128i *)&items[*w], cur);
+        *w += 16;
+        r += 16;
+    }
+
+    return r;
+}
+#endif
+
+size_t vector__unique(vector_t *vec, vector_compare_fn *compare, size_t size) {
+    if (!vec || size == 0 || vector__unshare(vec))
+        return vector__length(vec);
+
+    unsigned char *items = vec->items;
+    size_t r = size, w = size;
+
+    while (r < vec->length) {
+        size_t end = vec->length;
+
+#ifdef VECTOR_SSE2
+        if (!compare && size <= 8 && (size & (size - 1)) == 0) {
+            r = unique_sse2(items, vec->length, size, r, &w);
+            end = PF_MIN(r + 16, vec->length);
+        }
+#endif
+
+        for (; r < end; r += size) {
+            const void *last = &items[w - size];
+            if (compare ? 0 == compare(last, &items[r], size)
+                        : 0 == memcmp(last, &items[r], size))
+                continue;
+
+            if (w != r)
+                memcpy(&items[w], &items[r], size);
+            w += size;
+        }
+    }
+
+    vec->length = PF_MIN(w, vec->length);
+    return vec->length;
+}
+
+static inline hash_t dedup_hash(hash_fn *hash, const void *item, size_t size) {
+    return hash ? hash(item, NULL, libiter_hasher) : libiter_hasher(item, size);
+}
+
+static inline int dedup_equal(
+    hash_fn *hash, const void *x, const void *y, size_t size
+) {
+    return hash ? 0 == hash(x, y, libiter_hasher) : 0 == memcmp(x, y, size);
+}
+
+size_t vector__dedup_unsorted(vector_t *vec, hash_fn *hash, size_t size) {
+    if (!vec || size == 0)
+        return 0;
+
+    size_t count = vec->length / size;
+    if (count < 2 || vector__unshare(vec))
+        return vec->length;
+
+    if (count > SIZE_MAX / 4 / sizeof(size_t))
+        return vec->length;
+
+    /* slots store `index + 1` of kept items, 0 marks an empty slot. */
+    allocator_t *allocator = scratch_allocator(vec);
+    size_t capacity = pf_pow2ceilsize(count * 2);
+    size_t *slots = allocate(allocator, capacity * sizeof(size_t));
+
+    if (!slots)
+        return vec->length;
+
+    memset(slots, 0, capacity * sizeof(size_t));
+
+    unsigned char *items = vec->items;
+    size_t w = 0, mask = capacity - 1;
+
+    for (size_t r = 0; r < vec->length; r += size) {
+        size_t s = dedup_hash(hash, &items[r], size) & mask;
+
+        while (slots[s]) {
+            const void *kept = &items[(slots[s] - 1) * size];
+            if (dedup_equal(hash, kept, &items[r], size))
+                break;
+            s = (s + 1) & mask;
+        }
+
+        if (slots[s])
+            continue;
+
+        if (w != r)
+            memcpy(&items[w], &items[r], size);
+
+        slots[s] = w / size + 1;
+        w += size;
+    }
+
+    deallocate(allocator, slots, capacity * sizeof(size_t));
+    vec->length = w;
+    return w;
+}
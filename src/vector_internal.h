@@ -0,0 +1,37 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef LIBITER_VECTOR_INTERNAL_H
+#define LIBITER_VECTOR_INTERNAL_H
+
+#include <allocator.h>
+#include <iter/vector.h>
+#include <pf_macro.h>
+#include <string.h>
+
+extern allocator_t *libiter_allocator;
+
+/* Allocator for temporary buffers, wrapped vectors might not have one. */
+static inline allocator_t *scratch_allocator(const vector_t *vec) {
+    return vec->allocator ? vec->allocator : libiter_allocator;
+}
+
+/* Swaps two non-overlapping ranges through a small buffer on the stack. */
+static inline void swap_bytes(void *lhs, void *rhs, size_t size) {
+    unsigned char *a = lhs, *b = rhs;
+    unsigned char tmp[64];
+
+    for (size_t n = size; n > 0;) {
+        size_t chunk = PF_MIN(n, sizeof(tmp));
+        memcpy(tmp, a, chunk);
+        memcpy(a, b, chunk);
+        memcpy(b, tmp, chunk);
+        a += chunk, b += chunk, n -= chunk;
+    }
+}
+
+#endif
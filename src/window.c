@@ -0,0 +1,274 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <allocator.h>
+#include <iter/error.h>
+#include <pf_macro.h>
+#include <stdint.h>
+#include <string.h>
+
+#undef ITER_API
+#define ITER_API
+#include <iter/iter.h>
+
+extern allocator_t *libiter_allocator;
+
+/* Layout shared by every `iter_span(T)`. */
+struct span {
+    const void *items;
+    size_t length;
+};
+
+/*
+    `items` holds a run of `count` items taken from the source, of which
+    `pos` have been used. If `contiguous` is set, the run holds every
+    remaining item and spans point into it. Otherwise, the run is read
+    before the source, and items are gathered into `buffer`, where the
+    current window is `[start, end)`. Buffers of windows hold `2 * n`
+    items, so that `step` more items fit behind most windows.
+*/
+struct window {
+    allocator_t *allocator;
+    size_t bytes;
+    iter_t *src;
+    size_t size, n, step;
+    int chunks;
+    int contiguous;
+    int started;
+
+    const unsigned char *items;
+    size_t count, pos;
+
+    unsigned char *buffer;
+    size_t capacity;
+    size_t start, end;
+};
+
+static void window_free(iter_t *it, struct window *w) {
+    deallocate(w->allocator, w, w->bytes);
+    *(struct window **)ITER__CAST(it) = NULL;
+}
+
+static size_t window_read(struct window *w, unsigned char *out, size_t max) {
+    size_t taken = PF_MIN(max, w->count - w->pos);
+
+    if (taken > 0) {
+        memcpy(out, w->items + w->pos * w->size, taken * w->size);
+        w->pos += taken;
+    }
+
+    if (taken < max) {
+        out += taken * w->size;
+        taken += iter__next_n(w->src, out, max - taken, w->size);
+    }
+
+    return taken;
+}
+
+static void window_skip(struct window *w, size_t skip) {
+    size_t taken = PF_MIN(skip, w->count - w->pos);
+
+    w->pos += taken;
+    if (skip > taken)
+        iter__call(w->src, NULL, w->size, skip - taken);
+}
+
+static int contiguous_next(struct window *w, struct span *span) {
+    size_t left = w->count - w->pos;
+
+    if (left == 0 || (!w->chunks && left < w->n))
+        return ITER_ENODATA;
+
+    span->items = w->items + w->pos * w->size;
+    span->length = PF_MIN(w->n, left);
+    w->pos += PF_MIN(w->chunks ? w->n : w->step, left);
+    return ITER_OK;
+}
+
+static int buffered_next(struct window *w, struct span *span) {
+    size_t length;
+
+    if (w->chunks) {
+        length = window_read(w, w->buffer, w->n);
+        w->start = 0;
+    } else if (!w->started || w->step >= w->n) {
+        if (w->started)
+            window_skip(w, w->step - w->n);
+
+        w->started = 1;
+        w->start = 0;
+        length = window_read(w, w->buffer, w->n);
+    } else {
+        size_t kept = w->n - w->step;
+
+        /* moves the overlap to the front once `step` items don't fit. */
+        if (w->end + w->step > w->capacity) {
+            memmove(
+                w->buffer,
+                w->buffer + (w->start + w->step) * w->size,
+                kept * w->size
+            );
+            w->start = 0;
+            w->end = kept;
+        } else {
+            w->start += w->step;
+        }
+
+        length = kept + window_read(
+            w, w->buffer + w->end * w->size, w->step
+        );
+    }
+
+    if (length == 0 || (!w->chunks && length < w->n))
+        return ITER_ENODATA;
+
+    w->end = w->start + length;
+    span->items = w->buffer + w->start * w->size;
+    span->length = length;
+    return ITER_OK;
+}
+
+static int window_iter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    if (ITER_IS_OPS_QUERY(out, size, skip))
+        return ITER_HAS_OPS;
+
+    if (!it)
+        return ITER_EINVAL;
+
+    struct window *w = *(struct window **)ITER__CAST(it);
+
+    if (it == out) {
+        if (w)
+            window_free(it, w);
+        return ITER_OK;
+    }
+
+    if (!w)
+        return ITER_ENODATA;
+
+    if (size != sizeof(struct span))
+        return ITER_EINVAL;
+
+    struct span span;
+    for (skip += out ? 1 : 0; skip > 0; skip--) {
+        int status = w->contiguous ? contiguous_next(w, &span)
+                                   : buffered_next(w, &span);
+
+        if (status) {
+            window_free(it, w);
+            return status;
+        }
+    }
+
+    if (out)
+        memcpy(out, &span, sizeof(span));
+    return ITER_OK;
+}
+
+static void window_size_hint(
+    iter_t *it, size_t *lower, size_t *upper, size_t size
+) {
+    (void)size;
+
+    struct window *w = *(struct window **)ITER__CAST(it);
+
+    if (!w) {
+        *lower = *upper = 0;
+        return;
+    }
+
+    if (!w->contiguous)
+        return;
+
+    size_t left = w->count - w->pos;
+
+    if (w->chunks)
+        *lower = *upper = left / w->n + (left % w->n ? 1 : 0);
+    else
+        *lower = *upper = left < w->n ? 0 : (left - w->n) / w->step + 1;
+}
+
+static const struct iter_ops window_iter_ops = {
+    NULL,
+    NULL,
+    NULL,
+    window_size_hint,
+};
+
+static iter_t *window_create(
+    iter_t *out,
+    iter_t *src,
+    size_t n,
+    size_t step,
+    int chunks,
+    allocator_t *allocator,
+    size_t size
+) {
+    if (!out || !src || n == 0 || step == 0 || size == 0)
+        return NULL;
+
+    if (!allocator)
+        allocator = libiter_allocator;
+
+    const void *items = NULL;
+    size_t count = 0, lower, upper;
+
+    /* a single run followed by nothing is every item of the source. */
+    int status = iter__next_span(src, &items, &count, NULL, size);
+    iter__size_hint(src, &lower, &upper, size);
+
+    int contiguous = status == ITER_ENODATA || (!status && upper == 0);
+    size_t bytes = PF_ALIGN_UP(sizeof(struct window), alignof(max_align_t));
+
+    if (status)
+        items = NULL, count = 0;
+
+    if (!contiguous && n > (SIZE_MAX - bytes) / 2 / size)
+        return NULL;
+
+    size_t capacity = contiguous ? 0 : (chunks ? n : n * 2);
+
+    struct window *w = allocate(allocator, bytes + capacity * size);
+    if (!w)
+        return NULL;
+
+    memset(w, 0, sizeof(*w));
+    w->allocator = allocator;
+    w->bytes = bytes + capacity * size;
+    w->src = src;
+    w->size = size;
+    w->n = n;
+    w->step = step;
+    w->chunks = chunks;
+    w->contiguous = contiguous;
+    w->items = items;
+    w->count = count;
+    w->buffer = capacity ? PF_OFFSET(w, bytes) : NULL;
+    w->capacity = capacity;
+
+    out->call = &window_iter_fn;
+    out->ops = &window_iter_ops;
+    *(struct window **)ITER__CAST(out) = w;
+    return out;
+}
+
+iter_t *iter__chunks(
+    iter_t *out, iter_t *src, size_t n, allocator_t *allocator, size_t size
+) {
+    return window_create(out, src, n, n, 1, allocator, size);
+}
+
+iter_t *iter__windows(
+    iter_t *out,
+    iter_t *src,
+    size_t n,
+    size_t step,
+    allocator_t *allocator,
+    size_t size
+) {
+    return window_create(out, src, n, step, 0, allocator, size);
+}
@@ -0,0 +1,123 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <iter/cvector.h>
+#include <iter/vector.h>
+#include <pf_assert.h>
+#include <pf_test.h>
+#include <pthread.h>
+
+int test_cvector_create(int seed, int rep) {
+    cvector(int) cv = cvector_create(int, NULL);
+    pf_assert_not_null(cv);
+    pf_assert(0 == cvector_length(cv));
+    pf_assert_null(cvector_get(cv, 0));
+
+    cvector_destroy(cv);
+    return 0;
+}
+
+int test_cvector_push(int seed, int rep) {
+    int a[] = { 1, 2, 3, 4, 5 };
+    size_t index;
+
+    cvector(int) cv = cvector_with_capacity(int, 2, NULL);
+    pf_assert_not_null(cv);
+
+    pf_assert_ok(cvector_push(cv, (int *)a, 5, &index));
+    pf_assert(0 == index);
+    pf_assert_ok(cvector_push(cv, (int *)a, 3, &index));
+    pf_assert(5 == index);
+    pf_assert(8 == cvector_length(cv));
+
+    for (size_t i = 0; i < 8; i++)
+        pf_assert(*cvector_get(cv, i) == a[i % 5]);
+
+    pf_assert_null(cvector_get(cv, 8));
+    pf_assert(ITER_EINVAL == cvector_push(cv, (int *)NULL, 1, NULL));
+    pf_assert(ITER_EINVAL == cvector_push(cv, (int *)a, 0, NULL));
+
+    cvector_destroy(cv);
+    return 0;
+}
+
+int test_cvector_seal(int seed, int rep) {
+    int a[] = { 1, 2, 3, 4, 5 };
+
+    cvector(int) cv = cvector_with_capacity(int, 8, NULL);
+    pf_assert_not_null(cv);
+    pf_assert_ok(cvector_push(cv, (int *)a, 5, NULL));
+
+    int *first = cvector_get(cv, 0);
+    vector(int) v = cvector_seal(cv);
+    pf_assert_not_null(v);
+    pf_assert(vector_items(v) == first);
+    pf_assert(5 == vector_length(v));
+    pf_assert_memcmp(a, vector_items(v), sizeof(a));
+    vector_destroy(v);
+
+    cv = cvector_with_capacity(int, 1, NULL);
+    pf_assert_not_null(cv);
+    for (int i = 0; i < 100; i++)
+        pf_assert_ok(cvector_push(cv, &i, 1, NULL));
+
+    v = cvector_seal(cv);
+    pf_assert_not_null(v);
+    pf_assert(100 == vector_length(v));
+    for (int i = 0; i < 100; i++)
+        pf_assert(*vector_get(v, i) == i);
+
+    vector_destroy(v);
+    return 0;
+}
+
+#define PRODUCERS 64
+#define PRODUCER_ITEMS ((size_t)10000)
+
+static void *producer(void *user) {
+    cvector(size_t) cv = user;
+
+    for (size_t i = 0; i < PRODUCER_ITEMS; i++)
+        cvector_push(cv, &i, 1, NULL);
+
+    return NULL;
+}
+
+int test_cvector_concurrent(int seed, int rep) {
+    pthread_t threads[PRODUCERS];
+    size_t sum = 0;
+
+    cvector(size_t) cv = cvector_with_capacity(size_t, 16, NULL);
+    pf_assert_not_null(cv);
+
+    for (int i = 0; i < PRODUCERS; i++)
+        pf_assert_ok(pthread_create(&threads[i], NULL, producer, cv));
+
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_join(threads[i], NULL);
+
+    pf_assert(PRODUCERS * PRODUCER_ITEMS == cvector_length(cv));
+
+    vector(size_t) v = cvector_seal(cv);
+    pf_assert_not_null(v);
+
+    for (size_t i = 0; i < vector_length(v); i++)
+        sum += *vector_get(v, i);
+
+    pf_assert(sum == PRODUCERS * (PRODUCER_ITEMS * (PRODUCER_ITEMS - 1) / 2));
+
+    vector_destroy(v);
+    return 0;
+}
+
+pf_test suite_cvector[] = {
+    { test_cvector_create, "/cvector/create", 1 },
+    { test_cvector_push, "/cvector/push", 1 },
+    { test_cvector_seal, "/cvector/seal", 1 },
+    { test_cvector_concurrent, "/cvector/concurrent", 1 },
+    { 0 },
+};
@@ -0,0 +1,253 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <iter/file.h>
+#include <iter/iter.h>
+#include <iter/parallel.h>
+#include <iter/random.h>
+#include <iter/vector.h>
+#include <pf_assert.h>
+#include <pf_test.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int write_temp(char *path, const char *data, size_t length) {
+    strcpy(path, "/tmp/libiter-XXXXXX");
+
+    int fd = mkstemp(path);
+    if (fd < 0)
+        return -1;
+
+    ssize_t written = write(fd, data, length);
+    close(fd);
+    return written == (ssize_t)length ? 0 : -1;
+}
+
+static int view_equals(const iter_view_t *view, const char *str) {
+    return view->length == strlen(str)
+        && 0 == memcmp(view->data, str, view->length);
+}
+
+int test_file_lines(int seed, int rep) {
+    const char text[] = "one\ntwo\n\nthree\na longer line than 16 bytes\nz";
+    const char *lines[] = {
+        "one", "two", "", "three", "a longer line than 16 bytes", "z",
+    };
+
+    char path[32];
+    iter_view_t view;
+    iter_t storage;
+    size_t lower, upper;
+
+    pf_assert_ok(write_temp(path, text, sizeof(text) - 1));
+
+    iter(iter_view_t) it = iter_from_file_lines(&storage, path, NULL);
+    pf_assert_not_null(it);
+
+    iter_size_hint(it, &lower, &upper);
+    pf_assert(lower == 1 && upper == sizeof(text) - 1);
+
+    for (size_t i = 0; i < 6; i++) {
+        pf_assert_ok(iter_next(it, &view));
+        pf_assert(view_equals(&view, lines[i]));
+    }
+
+    pf_assert(ITER_ENODATA == iter_next(it, &view));
+    iter_free(it);
+
+    it = iter_from_file_lines(&storage, path, NULL);
+    pf_assert_ok(iter_nth(it, &view, 3));
+    pf_assert(view_equals(&view, "three"));
+    iter_free(it);
+
+    /* views collected from an exhausted iterator stay readable. */
+    it = iter_from_file_lines(&storage, path, NULL);
+    vector(iter_view_t) views = vector_from_iter(it, NULL);
+    pf_assert_not_null(views);
+    pf_assert(6 == vector_length(views));
+
+    for (size_t i = 0; i < 6; i++)
+        pf_assert(view_equals(vector_get(views, i), lines[i]));
+
+    vector_destroy(views);
+    iter_free(it);
+    unlink(path);
+
+    pf_assert_ok(write_temp(path, "", 0));
+    it = iter_from_file_lines(&storage, path, NULL);
+    pf_assert_not_null(it);
+    pf_assert(ITER_ENODATA == iter_next(it, &view));
+    iter_free(it);
+    unlink(path);
+
+    pf_assert_null(iter_from_file_lines(&storage, path, NULL));
+    return 0;
+}
+
+int test_file_records(int seed, int rep) {
+    char path[32];
+    iter_view_t view;
+    iter_t storage;
+    size_t lower, upper;
+
+    pf_assert_ok(write_temp(path, "aaaabbbbccccdddde", 17));
+    pf_assert_null(iter_from_file_records(&storage, path, 0, NULL));
+
+    iter(iter_view_t) it = iter_from_file_records(&storage, path, 4, NULL);
+    pf_assert_not_null(it);
+
+    iter_size_hint(it, &lower, &upper);
+    pf_assert(lower == 5 && upper == 5);
+
+    pf_assert_ok(iter_next(it, &view));
+    pf_assert(view_equals(&view, "aaaa"));
+    pf_assert_ok(iter_nth(it, &view, 2));
+    pf_assert(view_equals(&view, "dddd"));
+    pf_assert_ok(iter_next(it, &view));
+    pf_assert(view_equals(&view, "e"));
+    pf_assert(ITER_ENODATA == iter_next(it, &view));
+    iter_free(it);
+
+    it = iter_from_file_records(&storage, path, 4, NULL);
+    pf_assert(ITER_ENODATA == iter_advance(it, 6));
+    iter_free(it);
+
+    unlink(path);
+    return 0;
+}
+
+static int count_view(void *item, void *user) {
+    iter_view_t *view = item;
+    __atomic_fetch_add((size_t *)user, view->length + 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+int test_file_split(int seed, int rep) {
+    char text[4000], path[32];
+    size_t length = 0, lines = 0;
+
+    while (length < sizeof(text) - 40)
+        length += (size_t)sprintf(&text[length], "line %zu\n", lines++);
+
+    pf_assert_ok(write_temp(path, text, length));
+
+    iter_t storage, half;
+    iter_view_t view;
+
+    iter(iter_view_t) it = iter_from_file_lines(&storage, path, NULL);
+    iter(iter_view_t) back = iter_split(it, &half);
+    pf_assert_not_null(back);
+
+    size_t front = 0, total = 0;
+    while (!iter_next(it, &view)) {
+        pf_assert(view.data[view.length] == '\n');
+        front++;
+    }
+
+    pf_assert_ok(iter_next(back, &view));
+    pf_assert(view.data[-1] == '\n');
+    total = front + 1;
+    while (!iter_next(back, &view))
+        total++;
+
+    pf_assert(front > 0 && total == lines);
+    iter_free(it);
+    iter_free(back);
+
+    /* every line is counted with its newline, so the sum is the file size. */
+    size_t bytes = 0;
+    it = iter_from_file_lines(&storage, path, NULL);
+    pf_assert_ok(iter_parallel_each(it, count_view, &bytes));
+    pf_assert(bytes == length);
+    iter_free(it);
+
+    it = iter_from_file_records(&storage, path, 7, NULL);
+    back = iter_split(it, &half);
+    pf_assert_not_null(back);
+    iter_free(it);
+    iter_free(back);
+
+    unlink(path);
+    return 0;
+}
+
+struct keyed {
+    int key;
+    int seq;
+};
+
+static int compare_key(const void *lhs, const void *rhs, size_t size) {
+    return ((const struct keyed *)lhs)->key - ((const struct keyed *)rhs)->key;
+}
+
+int test_file_sort_external(int seed, int rep) {
+    iter_rng_t rng;
+    iter_rng_seed(&rng, (uint64_t)seed);
+
+    vector(struct keyed) items = vector_create(struct keyed, NULL);
+    pf_assert_not_null(items);
+
+    for (int i = 0; i < 10000; i++) {
+        struct keyed item = { (int)iter_rng_bounded(&rng, 100), i };
+        pf_assert_ok(vector_push(items, &item, 1));
+    }
+
+    iter_t storage, sorted;
+    struct keyed prev = { -1, -1 }, item;
+    size_t lower, upper, count = 0;
+
+    /* 4 KiB hold runs of 341 items, so about 30 runs are spilled. */
+    iter(struct keyed) it = iter_sort_external(
+        &sorted, vector_iter(items, &storage), compare_key, 4096, NULL, NULL
+    );
+    pf_assert_not_null(it);
+
+    iter_size_hint(it, &lower, &upper);
+    pf_assert(lower == 10000 && upper == 10000);
+
+    while (!iter_next(it, &item)) {
+        pf_assert(prev.key < item.key
+                  || (prev.key == item.key && prev.seq < item.seq));
+        prev = item;
+        count++;
+    }
+
+    pf_assert(count == 10000);
+
+    it = iter_sort_external(
+        &sorted, vector_iter(items, &storage), compare_key, 1 << 20, "/tmp",
+        NULL
+    );
+    pf_assert_not_null(it);
+    pf_assert_ok(iter_nth(it, &item, 9999));
+    pf_assert(item.key == 99);
+    pf_assert(ITER_ENODATA == iter_next(it, &item));
+
+    vector_clear(items);
+    it = iter_sort_external(
+        &sorted, vector_iter(items, &storage), compare_key, 4096, NULL, NULL
+    );
+    pf_assert(ITER_ENODATA == iter_next(it, &item));
+
+    it = iter_sort_external(
+        &sorted, vector_iter(items, &storage), compare_key, 8, NULL, NULL
+    );
+    pf_assert_null(it);
+
+    vector_destroy(items);
+    return 0;
+}
+
+pf_test suite_file[] = {
+    { test_file_lines, "/file/lines", 1 },
+    { test_file_records, "/file/records", 1 },
+    { test_file_split, "/file/split", 1 },
+    { test_file_sort_external, "/file/sort_external", 1 },
+    { 0 },
+};
@@ -0,0 +1,176 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <iter/gapvec.h>
+#include <iter/iter.h>
+#include <iter/vector.h>
+#include <pf_assert.h>
+#include <pf_macro.h>
+#include <pf_test.h>
+#include <stdlib.h>
+
+int test_gapvec_insert(int seed, int rep) {
+    int a[] = { 0, 1, 2, 3, 4 };
+    int b[] = { 0, 1, 7, 8, 2, 3, 4 };
+
+    gapvec(int) gv = gapvec_create(int, NULL);
+    pf_assert_not_null(gv);
+    pf_assert(0 == gapvec_length(gv));
+    pf_assert_null(gapvec_get(gv, 0));
+
+    pf_assert_ok(gapvec_insert(gv, a, 0, 5));
+    pf_assert_ok(gapvec_insert(gv, &b[2], 2, 2));
+    pf_assert(7 == gapvec_length(gv));
+    pf_assert(4 == gapvec_cursor(gv));
+
+    for (size_t i = 0; i < 7; i++)
+        pf_assert(*gapvec_get(gv, i) == b[i]);
+
+    pf_assert(ITER_EINVAL == gapvec_insert(gv, a, 8, 1));
+    pf_assert_null(gapvec_get(gv, 7));
+
+    pf_assert_memcmp(b, gapvec_flatten(gv), sizeof(b));
+    pf_assert(7 == gapvec_cursor(gv));
+
+    gapvec_destroy(gv);
+    return 0;
+}
+
+int test_gapvec_remove(int seed, int rep) {
+    int a[] = { 0, 1, 2, 3, 4, 5 };
+    int b[] = { 0, 4, 5 };
+
+    gapvec(int) gv = gapvec_create(int, NULL);
+    pf_assert_not_null(gv);
+    pf_assert_ok(gapvec_insert(gv, a, 0, 6));
+
+    pf_assert_ok(gapvec_remove(gv, 1, 3));
+    pf_assert(3 == gapvec_length(gv));
+    pf_assert(1 == gapvec_cursor(gv));
+
+    for (size_t i = 0; i < 3; i++)
+        pf_assert(*gapvec_get(gv, i) == b[i]);
+
+    pf_assert(ITER_EINVAL == gapvec_remove(gv, 1, 3));
+    pf_assert_ok(gapvec_remove(gv, 0, 3));
+    pf_assert(0 == gapvec_length(gv));
+    pf_assert_null(gapvec_flatten(gv));
+
+    gapvec_destroy(gv);
+    return 0;
+}
+
+int test_gapvec_spans(int seed, int rep) {
+    int a[] = { 0, 1, 2, 3, 4, 5 };
+    int *first, *second;
+    size_t first_len, second_len;
+
+    gapvec(int) gv = gapvec_create(int, NULL);
+    pf_assert_not_null(gv);
+    pf_assert_ok(gapvec_insert(gv, a, 0, 6));
+    pf_assert_ok(gapvec_move_gap(gv, 2));
+
+    pf_assert(6 == gapvec_spans(gv, &first, &first_len, &second, &second_len));
+    pf_assert(2 == first_len);
+    pf_assert(4 == second_len);
+    pf_assert_memcmp(a, first, 2 * sizeof(int));
+    pf_assert_memcmp(&a[2], second, 4 * sizeof(int));
+
+    pf_assert(ITER_EINVAL == gapvec_move_gap(gv, 7));
+
+    gapvec_destroy(gv);
+    return 0;
+}
+
+int test_gapvec_iter(int seed, int rep) {
+    int a[] = { 0, 1, 2, 3, 4, 5 };
+    int item;
+
+    gapvec(int) gv = gapvec_create(int, NULL);
+    pf_assert_not_null(gv);
+    pf_assert_ok(gapvec_insert(gv, a, 0, 6));
+    pf_assert_ok(gapvec_move_gap(gv, 3));
+
+    iter_t tmp;
+    iter(int) it = gapvec_iter(gv, &tmp);
+    pf_assert_not_null(it);
+
+    for (int i = 0; i < 6; i++) {
+        pf_assert_ok(iter_next(it, &item));
+        pf_assert(i == item);
+    }
+
+    pf_assert(ITER_ENODATA == iter_next(it, &item));
+
+    it = gapvec_iter(gv, &tmp);
+    pf_assert_ok(iter_nth(it, &item, 4));
+    pf_assert(4 == item);
+    pf_assert(ITER_ENODATA == iter_nth(it, &item, 1));
+
+    const int *items;
+    size_t count;
+    int b[6] = { 0 };
+
+    /* the gap splits items into two spans. */
+    it = gapvec_iter(gv, &tmp);
+    pf_assert_ok(iter_next_span(it, &items, &count, NULL));
+    pf_assert(count == 3 && items[0] == 0 && items[2] == 2);
+    pf_assert_ok(iter_next_span(it, &items, &count, NULL));
+    pf_assert(count == 3 && items[0] == 3 && items[2] == 5);
+    pf_assert(ITER_ENODATA == iter_next_span(it, &items, &count, NULL));
+
+    it = gapvec_iter(gv, &tmp);
+    pf_assert(2 == iter_next_n(it, b, 2));
+    pf_assert(4 == iter_next_n(it, &b[2], 5));
+    pf_assert_memcmp(a, b, sizeof(a));
+
+    gapvec_destroy(gv);
+    return 0;
+}
+
+int test_gapvec_edits(int seed, int rep) {
+    srand(seed);
+
+    gapvec(int) gv = gapvec_create(int, NULL);
+    vector(int) v = vector_create(int, NULL);
+    pf_assert_not_null(gv);
+    pf_assert_not_null(v);
+
+    for (int step = 0; step < 1000; step++) {
+        size_t length = vector_length(v);
+        int items[3] = { step, step + 1, step + 2 };
+
+        if (length > 0 && rand() % 3 == 0) {
+            size_t i = rand() % length;
+            size_t count = PF_MIN(length - i, (size_t)(1 + rand() % 3));
+            pf_assert_ok(gapvec_remove(gv, i, count));
+            pf_assert_ok(vector_remove(v, i, count));
+        } else {
+            size_t i = rand() % (length + 1);
+            size_t count = 1 + rand() % 3;
+            pf_assert_ok(gapvec_insert(gv, items, i, count));
+            pf_assert_ok(vector_insert(v, items, i, count));
+        }
+    }
+
+    pf_assert(vector_length(v) == gapvec_length(gv));
+    for (size_t i = 0; i < vector_length(v); i++)
+        pf_assert(*vector_get(v, i) == *gapvec_get(gv, i));
+
+    vector_destroy(v);
+    gapvec_destroy(gv);
+    return 0;
+}
+
+pf_test suite_gapvec[] = {
+    { test_gapvec_insert, "/gapvec/insert", 1 },
+    { test_gapvec_remove, "/gapvec/remove", 1 },
+    { test_gapvec_spans, "/gapvec/spans", 1 },
+    { test_gapvec_iter, "/gapvec/iter", 1 },
+    { test_gapvec_edits, "/gapvec/edits", 1 },
+    { 0 },
+};
@@ -0,0 +1,178 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <iter/group.h>
+#include <iter/iter.h>
+#include <iter/random.h>
+#include <pf_assert.h>
+#include <pf_test.h>
+
+struct sale {
+    int customer;
+    int amount;
+};
+
+typedef iter_pair(int, long) customer_total_t;
+
+static void sale_customer(void *key, const void *item, void *user) {
+    *(int *)key = ((const struct sale *)item)->customer;
+}
+
+static void total_init(void *acc, const void *key, void *user) {
+    *(long *)acc = 0;
+}
+
+static void total_add(void *acc, const void *item, void *user) {
+    *(long *)acc += ((const struct sale *)item)->amount;
+}
+
+int test_group_aggregate(int seed, int rep) {
+    iter_rng_t rng;
+    iter_rng_seed(&rng, (uint64_t)seed);
+
+    struct sale sales[1000];
+    long expected[50] = { 0 }, totals[50] = { 0 };
+
+    for (int i = 0; i < 1000; i++) {
+        sales[i].customer = (int)iter_rng_bounded(&rng, 50);
+        sales[i].amount = (int)iter_rng_bounded(&rng, 100);
+        expected[sales[i].customer] += sales[i].amount;
+    }
+
+    iter_t src, storage;
+    customer_total_t pair;
+    size_t count = 0;
+
+    iter(customer_total_t) it = iter_group_aggregate(
+        &storage, iter_from_array(&src, sales, 1000), customer_total_t,
+        sale_customer, total_init, total_add, NULL, 0, NULL
+    );
+    pf_assert_not_null(it);
+
+    while (!iter_next(it, &pair)) {
+        pf_assert(pair.first >= 0 && pair.first < 50);
+        pf_assert(totals[pair.first] == 0);
+        totals[pair.first] = pair.second;
+        count++;
+    }
+
+    pf_assert(count == 50);
+    for (int i = 0; i < 50; i++)
+        pf_assert(totals[i] == expected[i]);
+
+    /* early flushes return partial aggregates, which add up to the total. */
+    for (int i = 0; i < 50; i++)
+        totals[i] = 0;
+
+    count = 0;
+    it = iter_group_aggregate(
+        &storage, iter_from_array(&src, sales, 1000), customer_total_t,
+        sale_customer, total_init, total_add, NULL, 8, NULL
+    );
+
+    while (!iter_next(it, &pair)) {
+        totals[pair.first] += pair.second;
+        count++;
+    }
+
+    pf_assert(count > 50);
+    for (int i = 0; i < 50; i++)
+        pf_assert(totals[i] == expected[i]);
+
+    /* skips notice the end of every batch, and of the last one. */
+    const struct sale distinct[] = {
+        { 0, 1 }, { 1, 1 }, { 2, 1 }, { 3, 1 }, { 4, 1 }, { 5, 1 },
+    };
+    customer_total_t order[6];
+
+    it = iter_group_aggregate(
+        &storage, iter_from_array(&src, distinct, 6), customer_total_t,
+        sale_customer, total_init, total_add, NULL, 2, NULL
+    );
+    for (size_t i = 0; i < 6; i++)
+        pf_assert_ok(iter_next(it, &order[i]));
+    pf_assert(ITER_ENODATA == iter_next(it, &pair));
+
+    it = iter_group_aggregate(
+        &storage, iter_from_array(&src, distinct, 6), customer_total_t,
+        sale_customer, total_init, total_add, NULL, 2, NULL
+    );
+    pf_assert_ok(iter_nth(it, &pair, 3));
+    pf_assert(pair.first == order[3].first);
+    pf_assert_ok(iter_nth(it, &pair, 1));
+    pf_assert(pair.first == order[5].first);
+    pf_assert(ITER_ENODATA == iter_nth(it, &pair, 0));
+
+    it = iter_group_aggregate(
+        &storage, iter_from_array(&src, distinct, 6), customer_total_t,
+        sale_customer, total_init, total_add, NULL, 2, NULL
+    );
+    pf_assert(ITER_ENODATA == iter_nth(it, &pair, 6));
+
+    it = iter_group_aggregate(
+        &storage, iter_from_array(&src, distinct, 6), customer_total_t,
+        sale_customer, total_init, total_add, NULL, 0, NULL
+    );
+    pf_assert(ITER_ENODATA == iter_advance(it, 100));
+
+    it = iter_group_aggregate(
+        &storage, iter_from_array(&src, sales, 0), customer_total_t,
+        sale_customer, total_init, total_add, NULL, 0, NULL
+    );
+    pf_assert(ITER_ENODATA == iter_next(it, &pair));
+
+    return 0;
+}
+
+int test_group_aggregate_sorted(int seed, int rep) {
+    const struct sale sales[] = {
+        { 1, 10 }, { 1, 5 }, { 3, 7 }, { 4, 1 }, { 4, 2 }, { 4, 3 }, { 1, 8 },
+    };
+
+    const customer_total_t expected[] = {
+        { 1, 15 }, { 3, 7 }, { 4, 6 }, { 1, 8 },
+    };
+
+    iter_t src, storage;
+    customer_total_t pair;
+
+    iter(customer_total_t) it = iter_group_aggregate_sorted(
+        &storage, iter_from_array(&src, sales, 7), customer_total_t,
+        sale_customer, total_init, total_add, NULL, NULL
+    );
+    pf_assert_not_null(it);
+
+    for (size_t i = 0; i < 4; i++) {
+        pf_assert_ok(iter_next(it, &pair));
+        pf_assert(pair.first == expected[i].first);
+        pf_assert(pair.second == expected[i].second);
+    }
+
+    pf_assert(ITER_ENODATA == iter_next(it, &pair));
+
+    it = iter_group_aggregate_sorted(
+        &storage, iter_from_array(&src, sales, 7), customer_total_t,
+        sale_customer, total_init, total_add, NULL, NULL
+    );
+    pf_assert_ok(iter_nth(it, &pair, 2));
+    pf_assert(pair.first == 4 && pair.second == 6);
+    iter_free(it);
+
+    it = iter_group_aggregate_sorted(
+        &storage, iter_from_array(&src, sales, 0), customer_total_t,
+        sale_customer, total_init, total_add, NULL, NULL
+    );
+    pf_assert(ITER_ENODATA == iter_next(it, &pair));
+
+    return 0;
+}
+
+pf_test suite_group[] = {
+    { test_group_aggregate, "/group/aggregate", 1 },
+    { test_group_aggregate_sorted, "/group/aggregate_sorted", 1 },
+    { 0 },
+};
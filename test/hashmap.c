@@ -119,6 +119,37 @@ static int each_pair(void *key, void *value, void *user) {
     return 0;
 }
 
+int test_hashmap_upsert(int seed, int rep) {
+    hashmap(int, int) map = hashmap_create(int, int, NULL);
+    pf_assert_not_null(map);
+
+    int inserted;
+
+    /* counts occurrences of each key, initializing the new ones. */
+    for (int i = 0; i < 100; i++) {
+        int key = i % 7;
+        int *count = hashmap_upsert(map, &key, &inserted);
+        pf_assert_not_null(count);
+        pf_assert(inserted == (i < 7));
+
+        if (inserted)
+            *count = 0;
+        (*count)++;
+    }
+
+    pf_assert(hashmap_count(map) == 7);
+
+    for (int key = 0; key < 7; key++)
+        pf_assert(*hashmap_get(map, &key) == (key < 2 ? 15 : 14));
+
+    int key = 3;
+    pf_assert_not_null(hashmap_upsert(map, &key, NULL));
+    pf_assert_null(hashmap_upsert(map, (int *)NULL, &inserted));
+
+    hashmap_destroy(map);
+    return 0;
+}
+
 int test_hashmap_each(int seed, int rep) {
     int keys[5] = { 1, 2, 3, 4, 5 };
     double values[5] = { 1.1, 2.2, 3.3, 4.4, 5.5 };
@@ -225,6 +256,113 @@ int test_hashmap_iter_ref(int seed, int rep) {
     return 0;
 }
 
+int test_hashmap_iter_next_n(int seed, int rep) {
+    iter_t storage;
+    int values[100];
+    int *refs[100];
+
+    hashmap(int, int) map = hashmap_create(int, int, NULL);
+    pf_assert_not_null(map);
+
+    for (int i = 0; i < 100; i++)
+        pf_assert_ok(hashmap_insert(map, &i, &i));
+
+    for (int i = 0; i < 100; i += 3)
+        pf_assert_ok(hashmap_remove(map, &i));
+
+    iter(int) it = hashmap_iter(map, &storage);
+    pf_assert_not_null(it);
+    pf_assert(10 == iter_next_n(it, values, 10));
+    pf_assert(56 == iter_next_n(it, &values[10], 90));
+
+    int sum = 0;
+    for (size_t i = 0; i < 66; i++) {
+        pf_assert(values[i] % 3 != 0);
+        sum += values[i];
+    }
+
+    pf_assert(sum == 4950 - 1683);
+
+    iter(int *) rit = hashmap_iter_ref(map, &storage);
+    pf_assert_not_null(rit);
+    pf_assert(66 == iter_next_n(rit, refs, 100));
+
+    for (size_t i = 0; i < 66; i++)
+        pf_assert(*refs[i] == values[i]);
+
+    hashmap_destroy(map);
+    return 0;
+}
+
+int test_hashmap_iter_next_span(int seed, int rep) {
+    iter_t storage;
+    const int *span;
+    size_t count, seen = 0;
+    uint64_t mask;
+    int sum = 0;
+
+    hashmap(int, int) map = hashmap_create(int, int, NULL);
+    pf_assert_not_null(map);
+
+    for (int i = 0; i < 50; i++)
+        pf_assert_ok(hashmap_insert(map, &i, &i));
+
+    iter(int) it = hashmap_iter(map, &storage);
+    while (!iter_next_span(it, &span, &count, NULL)) {
+        for (size_t i = 0; i < count; i++, seen++)
+            sum += span[i];
+    }
+
+    pf_assert(seen == 50);
+    pf_assert(sum == 1225);
+
+    it = hashmap_iter(map, &storage);
+    while (!iter_next_span(it, &span, &count, &mask)) {
+        for (size_t i = 0; i < count; i++)
+            sum -= mask >> i & 1 ? span[i] : 0;
+    }
+
+    pf_assert(sum == 0);
+    hashmap_destroy(map);
+    return 0;
+}
+
+int test_hashmap_iter_split(int seed, int rep) {
+    iter_t storage, half;
+    int expected[500], actual[500];
+
+    hashmap(int, int) map = hashmap_create(int, int, NULL);
+    pf_assert_not_null(map);
+
+    for (int i = 0; i < 500; i++)
+        pf_assert_ok(hashmap_insert(map, &i, &i));
+
+    iter(int) it = hashmap_iter(map, &storage);
+    pf_assert(500 == iter_next_n(it, expected, 500));
+
+    it = hashmap_iter(map, &storage);
+    pf_assert_ok(iter_advance(it, 3));
+
+    iter(int) back = iter_split(it, &half);
+    pf_assert_not_null(back);
+
+    size_t front_hint, back_hint, upper;
+    iter_size_hint(it, &front_hint, &upper);
+    pf_assert(front_hint == upper);
+    iter_size_hint(back, &back_hint, NULL);
+    pf_assert(front_hint + back_hint == 497);
+
+    size_t count = iter_next_n(it, actual, 500);
+    pf_assert(count == front_hint);
+    count += iter_next_n(back, &actual[count], 500);
+
+    pf_assert(count == 497);
+    pf_assert_memcmp(&expected[3], actual, count * sizeof(int));
+
+    hashmap_destroy(map);
+    return 0;
+}
+
 pf_test suite_hashmap[] = {
     { test_hashmap_init, "/hashmap/init", 1 },
     { test_hashmap_create, "/hashmap/create", 1 },
@@ -232,9 +370,13 @@ pf_test suite_hashmap[] = {
     { test_hashmap_reserve, "/hashmap/reserve", 1 },
     { test_hashmap_get_set, "/hashmap/get_set", 1 },
     { test_hashmap_insert_remove, "/hashmap/insert_remove", 1 },
+    { test_hashmap_upsert, "/hashmap/upsert", 1 },
     { test_hashmap_each, "/hashmap/each", 1 },
     { test_hashmap_filter, "/hashmap/filter", 1 },
     { test_hashmap_iter, "/hashmap/iter", 1 },
     { test_hashmap_iter_ref, "/hashmap/iter_ref", 1 },
+    { test_hashmap_iter_next_n, "/hashmap/iter_next_n", 1 },
+    { test_hashmap_iter_next_span, "/hashmap/iter_next_span", 1 },
+    { test_hashmap_iter_split, "/hashmap/iter_split", 1 },
     { 0 },
 };
@@ -5,9 +5,13 @@
     SPDX-License-Identifier: Apache-2.0
 */
 
+#include <iter/generator.h>
 #include <iter/iter.h>
+#include <iter/vector.h>
 #include <pf_assert.h>
 #include <pf_test.h>
+#include <stdint.h>
+#include <string.h>
 
 int test_iter_from_array(int seed, int rep) {
     int out, a[] = { 1, 2, 3, 4, 5 };
@@ -58,9 +62,566 @@ int test_iter_to_array(int seed, int rep) {
     return 0;
 }
 
+struct counter {
+    int next, end;
+};
+
+/* Written against the original interface, which only sets `call`. */
+static int counter_fn(iter_t *it, void *out, size_t size, size_t skip) {
+    struct counter *c = ITER__CAST(it);
+
+    if (it == out)
+        return ITER_OK;
+
+    c->next += (int)skip;
+    if (!out)
+        return c->next <= c->end ? ITER_OK : ITER_ENODATA;
+
+    if (c->next >= c->end)
+        return ITER_ENODATA;
+
+    memcpy(out, &c->next, size);
+    c->next++;
+    return ITER_OK;
+}
+
+static iter_t *counter_iter(iter_t *out, int end) {
+    /* leaves garbage where `ops` is, like an uninitialized `iter_t`. */
+    memset(out, 0xA5, sizeof(*out));
+
+    struct counter *c = ITER__CAST(out);
+    c->next = 0;
+    c->end = end;
+    out->call = &counter_fn;
+    return out;
+}
+
+int test_iter_custom(int seed, int rep) {
+    int a[10] = { 0 }, b[4] = { 0 }, c[] = { 0, 1, 2, 3 };
+    size_t lower, upper;
+    iter_t storage;
+
+    iter(int) it = (iter(int))counter_iter(&storage, 10);
+    pf_assert(4 == iter_next_n(it, b, 4));
+    pf_assert_memcmp(c, b, sizeof(b));
+
+    iter_size_hint(it, &lower, &upper);
+    pf_assert(lower == 0 && upper == SIZE_MAX);
+    pf_assert_null(iter_split(it, &(iter_t){ 0 }));
+
+    const int *items;
+    size_t count;
+    pf_assert(ITER_ENOSYS == iter_next_span(it, &items, &count, NULL));
+
+    pf_assert(6 == iter_to_array(it, a, 10));
+    pf_assert(4 == a[0] && 9 == a[5]);
+
+    it = (iter(int))counter_iter(&storage, 10);
+    vector(int) v = vector_from_iter(it, NULL);
+    pf_assert_not_null(v);
+    pf_assert(10 == vector_length(v));
+
+    for (int i = 0; i < 10; i++)
+        pf_assert(i == *vector_get(v, i));
+
+    vector_destroy(v);
+    return 0;
+}
+
+int test_iter_next_span(int seed, int rep) {
+    int a[5] = { 1, 2, 3, 4, 5 };
+    const int *items;
+    size_t count;
+    uint64_t mask;
+    iter_t storage;
+
+    iter(int) it = iter_from_array(&storage, a, 5);
+    pf_assert_not_null(it);
+    pf_assert_ok(iter_advance(it, 2));
+
+    pf_assert_ok(iter_next_span(it, &items, &count, &mask));
+    pf_assert(items == &a[2] && count == 3 && mask == UINT64_MAX);
+    pf_assert(ITER_ENODATA == iter_next_span(it, &items, &count, NULL));
+
+    iter(int *) rit = iter_ref_from_array(&storage, (int *)a, 5);
+    pf_assert_not_null(rit);
+
+    int *const *refs;
+    pf_assert(ITER_ENOSYS == iter_next_span(rit, &refs, &count, NULL));
+
+    return 0;
+}
+
+int test_iter_split(int seed, int rep) {
+    int a[9] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    int out[9];
+    iter_t storage, half, quarter;
+
+    iter(int) it = iter_from_array(&storage, a, 9);
+    pf_assert_ok(iter_advance(it, 1));
+
+    iter(int) back = iter_split(it, &half);
+    pf_assert(back == (void *)&half);
+
+    iter(int) mid = iter_split(it, &quarter);
+    pf_assert_not_null(mid);
+
+    pf_assert(2 == iter_next_n(it, out, 9));
+    pf_assert(2 == iter_next_n(mid, &out[2], 9));
+    pf_assert(4 == iter_next_n(back, &out[4], 9));
+    pf_assert_memcmp(&a[1], out, sizeof(int) * 8);
+
+    it = iter_from_array(&storage, a, 1);
+    pf_assert_null(iter_split(it, &half));
+
+    int **refs = (int **)out;
+    iter(int *) rit = iter_ref_from_array(&storage, (int *)a, 9);
+    iter(int *) rback = iter_split(rit, &half);
+    pf_assert_not_null(rback);
+    pf_assert(4 == iter_next_n(rit, refs, 9));
+    pf_assert(refs[0] == &a[0] && refs[3] == &a[3]);
+    pf_assert_ok(iter_next(rback, refs));
+    pf_assert(refs[0] == &a[4]);
+
+    return 0;
+}
+
+static int compare_int(const void *lhs, const void *rhs, size_t size) {
+    return *(const int *)lhs - *(const int *)rhs;
+}
+
+int test_iter_next_n(int seed, int rep) {
+    int a[7] = { 1, 2, 3, 4, 5, 6, 7 };
+    int out[4], *refs[4];
+    iter_t storage;
+
+    iter(int) it = iter_from_array(&storage, a, 7);
+    pf_assert_not_null(it);
+
+    pf_assert(4 == iter_next_n(it, out, 4));
+    pf_assert_memcmp(a, out, sizeof(int) * 4);
+    pf_assert_ok(iter_next(it, &out[0]));
+    pf_assert(out[0] == 5);
+    pf_assert(2 == iter_next_n(it, out, 4));
+    pf_assert(out[0] == 6 && out[1] == 7);
+    pf_assert(0 == iter_next_n(it, out, 4));
+
+    iter(int *) rit = iter_ref_from_array(&storage, (int *)a, 7);
+    pf_assert_not_null(rit);
+    pf_assert_ok(iter_advance(rit, 5));
+    pf_assert(2 == iter_next_n(rit, refs, 4));
+    pf_assert(refs[0] == &a[5] && refs[1] == &a[6]);
+
+    /* iterators without a batch operation fall back to `iter_next`. */
+    iter_t sa, sb;
+    int b[] = { 0, 8 };
+    iter(int) inputs[] = {
+        iter_from_array(&sa, a, 7),
+        iter_from_array(&sb, b, 2),
+    };
+
+    it = iter_merge(&storage, inputs, 2, compare_int, NULL);
+    pf_assert_not_null(it);
+    pf_assert(4 == iter_next_n(it, out, 4));
+    pf_assert(out[0] == 0 && out[1] == 1 && out[3] == 3);
+    iter_free(it);
+
+    return 0;
+}
+
+int test_iter_merge(int seed, int rep) {
+    int a[] = { 1, 4, 7, 10 }, b[] = { 2, 5, 8 }, c[] = { 3, 6, 9, 11, 12 };
+    iter_t sa, sb, sc, storage;
+    int out;
+
+    iter(int) inputs[] = {
+        iter_from_array(&sa, a, 4),
+        iter_from_array(&sb, b, 3),
+        iter_from_array(&sc, c, 5),
+    };
+
+    iter(int) it = iter_merge(&storage, inputs, 3, compare_int, NULL);
+    pf_assert_not_null(it);
+
+    for (int i = 1; i <= 12; i++) {
+        pf_assert_ok(iter_next(it, &out));
+        pf_assert(out == i);
+    }
+
+    pf_assert(ITER_ENODATA == iter_next(it, &out));
+
+    it = iter_merge(&storage, inputs, 0, compare_int, NULL);
+    pf_assert_not_null(it);
+    pf_assert(ITER_ENODATA == iter_next(it, &out));
+
+    iter_from_array(&sa, a, 4);
+    iter_from_array(&sc, c, 5);
+    it = iter_merge(&storage, inputs, 3, compare_int, NULL);
+    pf_assert_not_null(it);
+    pf_assert_ok(iter_nth(it, &out, 2));
+    pf_assert(out == 4);
+    iter_free(it);
+
+    return 0;
+}
+
+static int halve(void *dst, void *src, void *user) {
+    *(double *)dst = *(int *)src / 2.0;
+    return 0;
+}
+
+static int is_odd(const void *item, void *user) {
+    return *(const int *)item % 2;
+}
+
+int test_iter_map_filter(int seed, int rep) {
+    int a[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    iter_t sa, sb, sc;
+    double out;
+
+    iter(int) it = iter_from_array(&sa, a, 9);
+    iter(int) odd = iter_filter(&sb, it, is_odd, NULL);
+    iter(double) halves = iter_map(&sc, odd, double, halve, NULL);
+    pf_assert_not_null(halves);
+
+    pf_assert_ok(iter_next(halves, &out));
+    pf_assert(out == 0.5);
+    pf_assert_ok(iter_nth(halves, &out, 1));
+    pf_assert(out == 2.5);
+    pf_assert_ok(iter_advance(halves, 1));
+    pf_assert_ok(iter_next(halves, &out));
+    pf_assert(out == 4.5);
+    pf_assert(ITER_ENODATA == iter_next(halves, &out));
+
+    /* rejected items are never stored into `out`. */
+    int b[] = { 1, 2, 4 }, item = 0;
+    odd = iter_filter(&sb, iter_from_array(&sa, b, 3), is_odd, NULL);
+    pf_assert_ok(iter_next(odd, &item));
+    pf_assert(ITER_ENODATA == iter_next(odd, &item));
+    pf_assert(item == 1);
+
+    return 0;
+}
+
+int test_iter_take_skip_chain(int seed, int rep) {
+    int a[] = { 1, 2, 3, 4, 5 }, b[] = { 6, 7, 8 };
+    int out[8], c[] = { 3, 4, 5, 6 };
+    iter_t sa, sb, s1, s2, s3;
+
+    iter(int) first = iter_from_array(&sa, a, 5);
+    iter(int) second = iter_from_array(&sb, b, 3);
+    iter(int) chain = iter_chain(&s1, first, second);
+    iter(int) skip = iter_skip(&s2, chain, 2);
+    iter(int) take = iter_take(&s3, skip, 5);
+    pf_assert_not_null(take);
+
+    pf_assert_ok(iter_next(take, &out[0]));
+    pf_assert(out[0] == 3);
+    pf_assert_ok(iter_nth(take, &out[0], 2));
+    pf_assert(out[0] == 6);
+    pf_assert_ok(iter_next(take, &out[0]));
+    pf_assert(out[0] == 7);
+    pf_assert(ITER_ENODATA == iter_next(take, &out[0]));
+
+    /* skipping crosses the end of the first iterator. */
+    iter_from_array(&sa, a, 5);
+    iter_from_array(&sb, b, 3);
+    chain = iter_chain(&s1, first, second);
+    pf_assert_ok(iter_nth(chain, &out[0], 6));
+    pf_assert(out[0] == 7);
+
+    iter_from_array(&sa, a, 5);
+    iter_from_array(&sb, b, 3);
+    chain = iter_chain(&s1, first, second);
+    take = iter_take(&s3, iter_skip(&s2, chain, 2), 4);
+    pf_assert(4 == iter_to_array(take, out, 8));
+    pf_assert_memcmp(c, out, sizeof(c));
+
+    return 0;
+}
+
+int test_iter_zip_enumerate(int seed, int rep) {
+    typedef iter_pair(int, double) pair_t;
+    typedef iter_indexed(pair_t) indexed_t;
+
+    int a[] = { 1, 2, 3, 4 };
+    double b[] = { 0.5, 1.5, 2.5 };
+    iter_t sa, sb, sz, se;
+    indexed_t out;
+
+    iter(int) ia = iter_from_array(&sa, a, 4);
+    iter(double) ib = iter_from_array(&sb, b, 3);
+    iter(pair_t) zip = iter_zip(&sz, ia, ib, pair_t);
+    iter(indexed_t) it = iter_enumerate(&se, zip, indexed_t);
+    pf_assert_not_null(it);
+
+    pf_assert_ok(iter_next(it, &out));
+    pf_assert(out.index == 0);
+    pf_assert(out.value.first == 1 && out.value.second == 0.5);
+
+    pf_assert_ok(iter_nth(it, &out, 1));
+    pf_assert(out.index == 2);
+    pf_assert(out.value.first == 3 && out.value.second == 2.5);
+
+    pf_assert(ITER_ENODATA == iter_next(it, &out));
+    return 0;
+}
+
+int test_iter_size_hint(int seed, int rep) {
+    int a[6] = { 1, 2, 3, 4, 5, 6 };
+    size_t lower, upper;
+    iter_t storage, other, adapter, filtered, chained;
+
+    iter(int) it = iter_from_array(&storage, a, 6);
+    pf_assert_ok(iter_advance(it, 1));
+    iter_size_hint(it, &lower, &upper);
+    pf_assert(lower == 5 && upper == 5);
+
+    iter(int) fit = iter_filter(&adapter, it, is_odd, NULL);
+    iter_size_hint(fit, &lower, &upper);
+    pf_assert(lower == 0 && upper == 5);
+
+    iter(int) tit = iter_take(&adapter, it, 3);
+    iter_size_hint(tit, &lower, &upper);
+    pf_assert(lower == 3 && upper == 3);
+
+    iter(int) sit = iter_skip(&adapter, it, 7);
+    iter_size_hint(sit, &lower, &upper);
+    pf_assert(lower == 0 && upper == 0);
+
+    iter(int) second = iter_from_array(&other, a, 2);
+    iter(int) cit = iter_chain(&adapter, it, second);
+    iter_size_hint(cit, &lower, &upper);
+    pf_assert(lower == 7 && upper == 7);
+
+    iter(int) fcit = iter_filter(&filtered, cit, is_odd, NULL);
+    iter(int) ccit = iter_chain(&chained, fcit, second);
+    iter_size_hint(ccit, NULL, &upper);
+    pf_assert(upper == 9);
+
+    iter(int) merged = iter_merge(&chained, &it, 1, compare_int, NULL);
+    iter_size_hint(merged, &lower, &upper);
+    pf_assert(lower == 0 && upper == SIZE_MAX);
+    iter_free(merged);
+
+    return 0;
+}
+
+typedef iter_span(int) int_span_t;
+
+static int is_not_negative(const void *item, void *user) {
+    return *(const int *)item >= 0;
+}
+
+/* Checks that `span` holds `length` items counting up from `first`. */
+static int span_equals(const int_span_t *span, int first, size_t length) {
+    if (span->length != length)
+        return 0;
+
+    for (size_t i = 0; i < length; i++)
+        if (span->items[i] != first + (int)i)
+            return 0;
+
+    return 1;
+}
+
+int test_iter_chunks(int seed, int rep) {
+    int a[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    iter_t storage, src;
+    int_span_t span;
+    size_t lower, upper;
+
+    iter(int_span_t) it = iter_chunks(
+        &storage, iter_from_array(&src, a, 10), int_span_t, 4, NULL
+    );
+    pf_assert_not_null(it);
+
+    iter_size_hint(it, &lower, &upper);
+    pf_assert(lower == 3 && upper == 3);
+
+    /* spans over arrays point into them. */
+    pf_assert_ok(iter_next(it, &span));
+    pf_assert(span.items == &a[0] && span_equals(&span, 0, 4));
+    pf_assert_ok(iter_next(it, &span));
+    pf_assert(span.items == &a[4] && span_equals(&span, 4, 4));
+    pf_assert_ok(iter_next(it, &span));
+    pf_assert(span.items == &a[8] && span_equals(&span, 8, 2));
+    pf_assert(ITER_ENODATA == iter_next(it, &span));
+
+    /* filters can't return spans, so chunks are buffered. */
+    iter_t filtered;
+    int b[20];
+    for (int i = 0; i < 20; i++)
+        b[i] = i % 2 ? -1 : i / 2;
+
+    it = iter_chunks(
+        &storage,
+        iter_filter(
+            &filtered, iter_from_array(&src, b, 20), is_not_negative, NULL
+        ),
+        int_span_t, 3, NULL
+    );
+    pf_assert_not_null(it);
+
+    for (int i = 0; i < 3; i++) {
+        pf_assert_ok(iter_next(it, &span));
+        pf_assert(span_equals(&span, i * 3, 3));
+    }
+
+    pf_assert_ok(iter_next(it, &span));
+    pf_assert(span_equals(&span, 9, 1));
+    pf_assert(ITER_ENODATA == iter_next(it, &span));
+
+    pf_assert_null(iter_chunks(
+        &storage, iter_from_array(&src, a, 10), int_span_t, 0, NULL
+    ));
+
+    return 0;
+}
+
+int test_iter_windows(int seed, int rep) {
+    int a[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    int b[60];
+    iter_t storage, src, filtered;
+    int_span_t span;
+    size_t lower, upper;
+
+    iter(int_span_t) it = iter_windows(
+        &storage, iter_from_array(&src, a, 10), int_span_t, 4, 3, NULL
+    );
+    pf_assert_not_null(it);
+
+    iter_size_hint(it, &lower, &upper);
+    pf_assert(lower == 3 && upper == 3);
+
+    for (int i = 0; i < 3; i++) {
+        pf_assert_ok(iter_next(it, &span));
+        pf_assert(span.items == &a[i * 3] && span_equals(&span, i * 3, 4));
+    }
+
+    pf_assert(ITER_ENODATA == iter_next(it, &span));
+
+    for (int i = 0; i < 60; i++)
+        b[i] = i % 2 ? -1 : i / 2;
+
+    /* buffered windows, overlapping and with gaps between them. */
+    const size_t steps[] = { 1, 2, 5, 7 };
+    for (size_t s = 0; s < 4; s++) {
+        size_t count = 0;
+
+        it = iter_windows(
+            &storage,
+            iter_filter(
+                &filtered, iter_from_array(&src, b, 60), is_not_negative,
+                NULL
+            ),
+            int_span_t, 5, steps[s], NULL
+        );
+        pf_assert_not_null(it);
+
+        while (!iter_next(it, &span)) {
+            pf_assert(span_equals(&span, (int)(count * steps[s]), 5));
+            count++;
+        }
+
+        pf_assert(count == (30 - 5) / steps[s] + 1);
+    }
+
+    it = iter_windows(
+        &storage, iter_from_array(&src, a, 10), int_span_t, 4, 1, NULL
+    );
+    pf_assert_ok(iter_nth(it, &span, 6));
+    pf_assert(span_equals(&span, 6, 4));
+    pf_assert(ITER_ENODATA == iter_next(it, &span));
+
+    it = iter_windows(
+        &storage, iter_from_array(&src, a, 3), int_span_t, 4, 1, NULL
+    );
+    pf_assert(ITER_ENODATA == iter_next(it, &span));
+
+    return 0;
+}
+
+struct fib {
+    unsigned long a, b;
+    int i, n;
+};
+
+static int fib_gen(iter_gen_t *gen, void *state, void *out) {
+    struct fib *f = state;
+
+    ITER_GEN_BEGIN(gen);
+    for (; f->i < f->n; f->i++) {
+        ITER_YIELD(gen, out, f->a);
+
+        unsigned long next = f->a + f->b;
+        f->a = f->b;
+        f->b = next;
+    }
+    ITER_GEN_END(gen);
+}
+
+static int wide_gen(iter_gen_t *gen, void *state, void *out) {
+    int *i = state;
+
+    ITER_GEN_BEGIN(gen);
+    ITER_YIELD(gen, out, *i + 1L);
+    ITER_GEN_END(gen);
+}
+
+int test_iter_generator(int seed, int rep) {
+    const unsigned long expected[] = { 0, 1, 1, 2, 3, 5, 8, 13, 21, 34 };
+    struct fib f = { 0, 1, 0, 10 };
+    unsigned long out;
+    iter_t storage;
+
+    iter(unsigned long) it = iter_generator(
+        &storage, unsigned long, fib_gen, &f
+    );
+    pf_assert_not_null(it);
+
+    for (size_t i = 0; i < 10; i++) {
+        pf_assert_ok(iter_next(it, &out));
+        pf_assert(out == expected[i]);
+    }
+
+    pf_assert(ITER_ENODATA == iter_next(it, &out));
+    pf_assert(ITER_ENODATA == iter_next(it, &out));
+
+    f = (struct fib){ 0, 1, 0, 10 };
+    it = iter_generator(&storage, unsigned long, fib_gen, &f);
+    pf_assert_ok(iter_nth(it, &out, 7));
+    pf_assert(out == 13);
+    pf_assert_ok(iter_next(it, &out));
+    pf_assert(out == 21);
+    iter_free(it);
+    pf_assert(ITER_ENODATA == iter_next(it, &out));
+
+    /* a `long` yielded from an `iter(int)` is rejected, not stored. */
+    int i = 41, item = 0, guard[2] = { -1, -1 };
+    iter(int) narrow = iter_generator(&storage, int, wide_gen, &i);
+    pf_assert(ITER_EINVAL == iter_next(narrow, &guard[0]));
+    pf_assert(guard[0] == -1 && guard[1] == -1);
+    pf_assert(ITER_ENODATA == iter_next(narrow, &item));
+
+    return 0;
+}
+
 pf_test suite_iter[] = {
     { test_iter_from_array, "/iter/from_array", 1 },
     { test_iter_ref_from_array, "/iter/ref_from_array", 1 },
     { test_iter_to_array, "/iter/to_array", 1 },
+    { test_iter_custom, "/iter/custom", 1 },
+    { test_iter_next_n, "/iter/next_n", 1 },
+    { test_iter_next_span, "/iter/next_span", 1 },
+    { test_iter_split, "/iter/split", 1 },
+    { test_iter_size_hint, "/iter/size_hint", 1 },
+    { test_iter_merge, "/iter/merge", 1 },
+    { test_iter_map_filter, "/iter/map_filter", 1 },
+    { test_iter_take_skip_chain, "/iter/take_skip_chain", 1 },
+    { test_iter_zip_enumerate, "/iter/zip_enumerate", 1 },
+    { test_iter_chunks, "/iter/chunks", 1 },
+    { test_iter_windows, "/iter/windows", 1 },
+    { test_iter_generator, "/iter/generator", 1 },
     { 0 },
 };
@@ -0,0 +1,196 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <iter/iter.h>
+#include <iter/join.h>
+#include <pf_assert.h>
+#include <pf_test.h>
+
+struct row {
+    int key;
+    int value;
+};
+
+typedef iter_pair(struct row, int) row_int_t;
+
+static int compare_row_int(const void *left, const void *right, void *user) {
+    return ((const struct row *)left)->key - *(const int *)right;
+}
+
+static void row_key(void *key, const void *item, void *user) {
+    *(int *)key = ((const struct row *)item)->key;
+}
+
+static void int_key(void *key, const void *item, void *user) {
+    *(int *)key = *(const int *)item;
+}
+
+/* Counts pairs with a nested loop, checking them against `it`. */
+static int check_join(
+    iter(row_int_t) it,
+    const struct row *left,
+    size_t llength,
+    const int *right,
+    size_t rlength
+) {
+    size_t expected = 0, count = 0;
+    row_int_t pair;
+
+    for (size_t i = 0; i < llength; i++)
+        for (size_t j = 0; j < rlength; j++)
+            expected += left[i].key == right[j];
+
+    while (!iter_next(it, &pair)) {
+        if (pair.first.key != pair.second)
+            return -1;
+        count++;
+    }
+
+    return count == expected ? 0 : -1;
+}
+
+int test_join_merge(int seed, int rep) {
+    const struct row left[] = {
+        { 1, 10 }, { 2, 20 }, { 2, 21 }, { 4, 40 }, { 5, 50 }, { 5, 51 },
+        { 7, 70 },
+    };
+    const int right[] = { 0, 2, 2, 3, 5, 6, 7, 7, 7 };
+
+    iter_t lstorage, rstorage, storage;
+    row_int_t pair;
+
+    iter(row_int_t) it = iter_merge_join(
+        &storage,
+        iter_from_array(&lstorage, left, 7),
+        iter_from_array(&rstorage, right, 9),
+        row_int_t, compare_row_int, NULL, NULL
+    );
+    pf_assert_not_null(it);
+
+    /* groups are paired in the order of `left`, then `right`. */
+    const int values[] = { 20, 20, 21, 21, 50, 51, 70, 70, 70 };
+    for (size_t i = 0; i < 9; i++) {
+        pf_assert_ok(iter_next(it, &pair));
+        pf_assert(pair.first.value == values[i]);
+        pf_assert(pair.first.key == pair.second);
+    }
+
+    pf_assert(ITER_ENODATA == iter_next(it, &pair));
+
+    it = iter_merge_join(
+        &storage,
+        iter_from_array(&lstorage, left, 7),
+        iter_from_array(&rstorage, right, 9),
+        row_int_t, compare_row_int, NULL, NULL
+    );
+    pf_assert_ok(iter_nth(it, &pair, 4));
+    pf_assert(pair.first.value == 50);
+    iter_free(it);
+
+    it = iter_merge_join(
+        &storage,
+        iter_from_array(&lstorage, left, 7),
+        iter_from_array(&rstorage, right, 0),
+        row_int_t, compare_row_int, NULL, NULL
+    );
+    pf_assert(ITER_ENODATA == iter_next(it, &pair));
+
+    return 0;
+}
+
+int test_join_hash(int seed, int rep) {
+    const struct row left[] = {
+        { 7, 70 }, { 2, 20 }, { 5, 50 }, { 1, 10 }, { 2, 21 }, { 5, 51 },
+        { 4, 40 },
+    };
+    const int right[] = { 7, 3, 2, 7, 0, 5, 2, 6, 7 };
+
+    iter_t lstorage, rstorage, storage;
+    row_int_t pair;
+
+    /* `left` is smaller, so it's built and `right` is streamed. */
+    iter(row_int_t) it = iter_hash_join(
+        &storage,
+        iter_from_array(&lstorage, left, 7),
+        iter_from_array(&rstorage, right, 9),
+        row_int_t, int, row_key, int_key, NULL, NULL
+    );
+    pf_assert_not_null(it);
+
+    const int values[] = { 70, 20, 21, 70, 50, 51, 20, 21, 70 };
+    for (size_t i = 0; i < 9; i++) {
+        pf_assert_ok(iter_next(it, &pair));
+        pf_assert(pair.first.value == values[i]);
+        pf_assert(pair.first.key == pair.second);
+    }
+
+    pf_assert(ITER_ENODATA == iter_next(it, &pair));
+
+    /* now `right` is smaller, so `left` is streamed. */
+    it = iter_hash_join(
+        &storage,
+        iter_from_array(&lstorage, left, 7),
+        iter_from_array(&rstorage, right, 4),
+        row_int_t, int, row_key, int_key, NULL, NULL
+    );
+    pf_assert_ok(iter_next(it, &pair));
+    pf_assert(pair.first.value == 70 && pair.second == 7);
+    pf_assert_ok(iter_next(it, &pair));
+    pf_assert(pair.first.value == 70 && pair.second == 7);
+    pf_assert_ok(iter_next(it, &pair));
+    pf_assert(pair.first.value == 20 && pair.second == 2);
+    iter_free(it);
+
+    it = iter_hash_join(
+        &storage,
+        iter_from_array(&lstorage, left, 7),
+        iter_from_array(&rstorage, right, 9),
+        row_int_t, int, row_key, int_key, NULL, NULL
+    );
+    pf_assert_ok(iter_nth(it, &pair, 8));
+    pf_assert(pair.first.value == 70);
+    pf_assert(ITER_ENODATA == iter_next(it, &pair));
+
+    return 0;
+}
+
+int test_join_many(int seed, int rep) {
+    struct row left[300];
+    int right[200];
+    iter_t lstorage, rstorage, storage;
+
+    /* keys are sorted, with runs of different lengths on both sides. */
+    for (int i = 0; i < 300; i++)
+        left[i] = (struct row) { i / 3, i };
+    for (int i = 0; i < 200; i++)
+        right[i] = i / 4 * 2;
+
+    iter(row_int_t) it = iter_merge_join(
+        &storage,
+        iter_from_array(&lstorage, left, 300),
+        iter_from_array(&rstorage, right, 200),
+        row_int_t, compare_row_int, NULL, NULL
+    );
+    pf_assert_ok(check_join(it, left, 300, right, 200));
+
+    it = iter_hash_join(
+        &storage,
+        iter_from_array(&lstorage, left, 300),
+        iter_from_array(&rstorage, right, 200),
+        row_int_t, int, row_key, int_key, NULL, NULL
+    );
+    pf_assert_ok(check_join(it, left, 300, right, 200));
+
+    return 0;
+}
+
+pf_test suite_join[] = {
+    { test_join_merge, "/join/merge", 1 },
+    { test_join_hash, "/join/hash", 1 },
+    { test_join_many, "/join/many", 1 },
+    { 0 },
+};
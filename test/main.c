@@ -8,16 +8,29 @@
 #include <pf_test.h>
 #include <string.h>
 
+extern pf_test suite_cvector[];
+extern pf_test suite_file[];
+extern pf_test suite_gapvec[];
+extern pf_test suite_group[];
 extern pf_test suite_hashmap[];
 extern pf_test suite_iter[];
+extern pf_test suite_join[];
+extern pf_test suite_parallel[];
+extern pf_test suite_pipeline[];
 extern pf_test suite_pool[];
+extern pf_test suite_strvec[];
 extern pf_test suite_vector[];
 
 static const pf_test *suites[] = {
-    suite_hashmap, suite_iter, suite_pool, suite_vector, NULL,
+    suite_cvector, suite_file, suite_gapvec, suite_group, suite_hashmap,
+    suite_iter, suite_join, suite_parallel, suite_pipeline, suite_pool,
+    suite_strvec, suite_vector, NULL,
 };
 
-static const char *names[] = { "hashmap", "iter", "pool", "vector", NULL };
+static const char *names[] = {
+    "cvector", "file", "gapvec", "group", "hashmap", "iter", "join",
+    "parallel", "pipeline", "pool", "strvec", "vector", NULL,
+};
 
 int main(int argc, char *argv[]) {
     if (argc > 2) {
@@ -0,0 +1,328 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <iter/iter.h>
+#include <iter/parallel.h>
+#include <iter/pool.h>
+#include <iter/vector.h>
+#include <pf_assert.h>
+#include <pf_test.h>
+#include <stdint.h>
+
+static vector(int) make_range(size_t count) {
+    vector(int) v = vector_with_capacity(int, count, NULL);
+
+    for (int i = 0; i < (int)count; i++)
+        vector_push(v, &i, 1);
+
+    return v;
+}
+
+static int count_index(size_t index, void *user) {
+    __atomic_fetch_add((size_t *)user, index + 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+int test_parallel_for(int seed, int rep) {
+    size_t sum = 0;
+
+    pf_assert_ok(parallel_for(1000, count_index, &sum));
+    pf_assert(sum == 1000 * 1001 / 2);
+
+    pf_assert_ok(parallel_for(0, count_index, &sum));
+    pf_assert(ITER_EINVAL == parallel_for(10, NULL, NULL));
+    return 0;
+}
+
+static int each_double(void *item, void *user) {
+    *(int *)item *= 2;
+    return 0;
+}
+
+static int each_stop(void *item, void *user) {
+    return *(int *)item == *(int *)user;
+}
+
+int test_vector_each_parallel(int seed, int rep) {
+    vector(int) v = make_range(100000);
+    pf_assert_not_null(v);
+
+    pf_assert_ok(vector_each_parallel(v, each_double, NULL, 0));
+    for (int i = 0; i < 100000; i++)
+        pf_assert(*vector_get(v, i) == 2 * i);
+
+    int stop = 1000;
+    pf_assert(ITER_EINTR == vector_each_parallel(v, each_stop, &stop, 16));
+    pf_assert(ITER_EINVAL == vector_each_parallel(v, NULL, NULL, 0));
+
+    vector_destroy(v);
+    return 0;
+}
+
+static int map_square(void *dst, void *src, void *user) {
+    *(long *)dst = (long)*(int *)src * *(int *)src;
+    return 0;
+}
+
+int test_vector_map_parallel(int seed, int rep) {
+    vector(int) src = make_range(50000);
+    vector(long) dst = vector_create(long, NULL);
+    pf_assert_not_null(src);
+    pf_assert_not_null(dst);
+
+    pf_assert_ok(vector_map_parallel(dst, src, map_square, NULL, 100));
+    pf_assert(vector_length(dst) == vector_length(src));
+
+    for (long i = 0; i < 50000; i++)
+        pf_assert(*vector_get(dst, i) == i * i);
+
+    vector_destroy(src);
+    vector_destroy(dst);
+    return 0;
+}
+
+static int reduce_sum(void *acc, const void *item, void *user) {
+    *(long *)acc += *(const long *)item;
+    return 0;
+}
+
+int test_vector_reduce_parallel(int seed, int rep) {
+    long sum, zero = 0;
+    vector(long) v = vector_with_capacity(long, 100000, NULL);
+    pf_assert_not_null(v);
+
+    for (long i = 0; i < 100000; i++)
+        vector_push(v, &i, 1);
+
+    pf_assert_ok(vector_reduce_parallel(v, &sum, &zero, reduce_sum, NULL, 0));
+    pf_assert(sum == 100000L * 99999L / 2);
+
+    size_t prev = libiter_use_threads(1);
+    pf_assert_ok(vector_reduce_parallel(v, &sum, &zero, reduce_sum, NULL, 7));
+    pf_assert(sum == 100000L * 99999L / 2);
+    libiter_use_threads(prev);
+
+    vector_clear(v);
+    pf_assert_ok(vector_reduce_parallel(v, &sum, &zero, reduce_sum, NULL, 0));
+    pf_assert(sum == 0);
+
+    vector_destroy(v);
+    return 0;
+}
+
+int test_vector_scan(int seed, int rep) {
+    uint32_t total;
+    vector(uint32_t) v = vector_create(uint32_t, NULL);
+    pf_assert_not_null(v);
+
+    for (uint32_t i = 0; i < 100003; i++)
+        vector_push(v, &i, 1);
+
+    pf_assert_ok(vector_scan_inclusive(v, &total));
+    pf_assert(total == (uint32_t)(100003UL * 100002UL / 2));
+
+    for (uint32_t i = 0; i < 100003; i++)
+        pf_assert(*vector_get(v, i) == (uint32_t)((uint64_t)i * (i + 1) / 2));
+
+    vector_clear(v);
+    for (uint32_t i = 0; i < 100003; i++)
+        vector_push(v, &(uint32_t){ 1 }, 1);
+
+    pf_assert_ok(vector_scan_exclusive(v, &total));
+    pf_assert(total == 100003);
+
+    for (uint32_t i = 0; i < 100003; i++)
+        pf_assert(*vector_get(v, i) == i);
+
+    vector_destroy(v);
+    return 0;
+}
+
+int test_vector_scan_types(int seed, int rep) {
+    int8_t a[] = { 1, -2, 3, -4, 5 }, sum8;
+    double b[] = { 0.5, 1, 2, 4, 8 }, sum64;
+    float c[] = { 1, 2, 3, 4, 5, 6, 7 }, sum32;
+
+    vector(int8_t) v8 = vector_from_array(a, 5, NULL);
+    pf_assert_ok(vector_scan_inclusive(v8, &sum8));
+    pf_assert(sum8 == 3);
+    pf_assert(*vector_get(v8, 3) == -2);
+
+    vector(double) v64 = vector_from_array(b, 5, NULL);
+    pf_assert_ok(vector_scan_exclusive(v64, &sum64));
+    pf_assert(sum64 == 15.5);
+    pf_assert(*vector_get(v64, 0) == 0);
+    pf_assert(*vector_get(v64, 4) == 7.5);
+
+    vector(float) v32 = vector_from_array(c, 7, NULL);
+    pf_assert_ok(vector_scan_inclusive(v32, (float *)NULL));
+    for (size_t i = 0; i < 7; i++)
+        pf_assert(*vector_get(v32, i) == (i + 1) * (i + 2) / 2);
+
+    pf_assert_ok(vector_scan_exclusive(v32, &sum32));
+    pf_assert(sum32 == 84);
+
+    vector_destroy(v8);
+    vector_destroy(v64);
+    vector_destroy(v32);
+    return 0;
+}
+
+int test_vector_shuffle_parallel(int seed, int rep) {
+    iter_rng_t a, b;
+    vector(uint32_t) v = vector_create(uint32_t, NULL);
+    pf_assert_not_null(v);
+
+    for (uint32_t i = 0; i < 300000; i++)
+        vector_push(v, &i, 1);
+
+    vector(uint32_t) w = vector_clone(v, NULL);
+    pf_assert_not_null(w);
+
+    iter_rng_seed(&a, 7);
+    iter_rng_seed(&b, 7);
+    pf_assert_ok(vector_shuffle_parallel(v, &a));
+
+    /* results don't depend on the number of threads. */
+    size_t prev = libiter_use_threads(1);
+    pf_assert_ok(vector_shuffle_parallel(w, &b));
+    libiter_use_threads(prev);
+
+    pf_assert_memcmp(vector_items(v), vector_items(w), 300000 * 4);
+
+    uint64_t sum = 0;
+    size_t moved = 0;
+    for (uint32_t i = 0; i < 300000; i++) {
+        sum += *vector_get(v, i);
+        moved += *vector_get(v, i) != i;
+    }
+
+    pf_assert(sum == 300000ull * 299999ull / 2);
+    pf_assert(moved > 290000);
+
+    vector_destroy(v);
+    vector_destroy(w);
+    return 0;
+}
+
+static int each_sum(void *item, void *user) {
+    __atomic_fetch_add((long *)user, *(long *)item, __ATOMIC_RELAXED);
+    return 0;
+}
+
+static int each_until(void *item, void *user) {
+    return *(long *)item == *(long *)user;
+}
+
+static int map_long(void *dst, void *src, void *user) {
+    *(long *)dst = *(long *)src;
+    return 0;
+}
+
+int test_iter_parallel(int seed, int rep) {
+    long sum = 0, zero = 0, total = 100000L * 99999L / 2;
+    iter_t storage, mapped;
+
+    vector(long) v = vector_with_capacity(long, 100000, NULL);
+    pool(long) p = pool_create(long, NULL);
+    pf_assert_not_null(v);
+    pf_assert_not_null(p);
+
+    for (long i = 0; i < 100000; i++) {
+        long *item = pool_take(p);
+        pf_assert_not_null(item);
+        *item = i;
+        vector_push(v, &i, 1);
+    }
+
+    pf_assert_ok(iter_parallel_each(vector_iter(v, &storage), each_sum, &sum));
+    pf_assert(sum == total);
+
+    pf_assert_ok(iter_parallel_reduce(
+        pool_iter(p, &storage), &sum, &zero, reduce_sum, NULL
+    ));
+    pf_assert(sum == total);
+
+    size_t prev = libiter_use_threads(1);
+    pf_assert_ok(iter_parallel_reduce(
+        pool_iter(p, &storage), &sum, &zero, reduce_sum, NULL
+    ));
+    pf_assert(sum == total);
+    libiter_use_threads(prev);
+
+    /* adapters can't be split, so they are reduced on the calling thread. */
+    iter(long) it = iter_map(
+        &mapped, vector_iter(v, &storage), long, map_long, NULL
+    );
+    pf_assert_ok(iter_parallel_reduce(it, &sum, &zero, reduce_sum, NULL));
+    pf_assert(sum == total);
+
+    long stop = 5000;
+    pf_assert(
+        ITER_EINTR
+        == iter_parallel_each(vector_iter(v, &storage), each_until, &stop)
+    );
+
+    vector_destroy(v);
+    pool_destroy(p);
+    return 0;
+}
+
+int test_iter_prefetch(int seed, int rep) {
+    vector(int) v = make_range(100000);
+    iter_t src, storage;
+    int out, batch[1000];
+
+    iter(int) it = iter_prefetch(
+        &storage, vector_iter(v, &src), 4, NULL
+    );
+    pf_assert_not_null(it);
+
+    for (int i = 0; i < 50000; i++) {
+        pf_assert_ok(iter_next(it, &out));
+        pf_assert(out == i);
+    }
+
+    pf_assert_ok(iter_nth(it, &out, 999));
+    pf_assert(out == 50999);
+
+    for (int i = 51000; i < 100000; i += 1000) {
+        pf_assert(1000 == iter_next_n(it, batch, 1000));
+        pf_assert(batch[0] == i && batch[999] == i + 999);
+    }
+
+    pf_assert(0 == iter_next_n(it, batch, 1000));
+    pf_assert(ITER_ENODATA == iter_next(it, &out));
+
+    /* freeing early stops the producer while the ring is full. */
+    it = iter_prefetch(&storage, vector_iter(v, &src), 2, NULL);
+    pf_assert_ok(iter_next(it, &out));
+    pf_assert(out == 0);
+    iter_free(it);
+    pf_assert(ITER_ENODATA == iter_next(it, &out));
+
+    it = iter_prefetch(&storage, iter_from_array(&src, batch, 0), 1, NULL);
+    pf_assert(ITER_ENODATA == iter_next(it, &out));
+
+    pf_assert_null(iter_prefetch(&storage, vector_iter(v, &src), 0, NULL));
+
+    vector_destroy(v);
+    return 0;
+}
+
+pf_test suite_parallel[] = {
+    { test_parallel_for, "/parallel/for", 1 },
+    { test_vector_each_parallel, "/parallel/vector_each", 1 },
+    { test_vector_map_parallel, "/parallel/vector_map", 1 },
+    { test_vector_reduce_parallel, "/parallel/vector_reduce", 1 },
+    { test_vector_scan, "/parallel/vector_scan", 1 },
+    { test_vector_scan_types, "/parallel/vector_scan_types", 1 },
+    { test_vector_shuffle_parallel, "/parallel/vector_shuffle", 1 },
+    { test_iter_parallel, "/parallel/iter", 1 },
+    { test_iter_prefetch, "/parallel/prefetch", 1 },
+    { 0 },
+};
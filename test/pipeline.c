@@ -0,0 +1,109 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <iter/pipeline.h>
+#include <pf_assert.h>
+#include <pf_test.h>
+
+static inline int is_even(int x) {
+    return x % 2 == 0;
+}
+
+static inline long square(int x) {
+    return (long)x * x;
+}
+
+static inline long add(long acc, long x) {
+    return acc + x;
+}
+
+#define BELOW_50(x) ((x) < 50)
+
+int test_pipeline_vector(int seed, int rep) {
+    vector(int) v = vector_create(int, NULL);
+    pf_assert_not_null(v);
+
+    for (int i = 0; i < 100; i++)
+        pf_assert_ok(vector_push(v, &i, 1));
+
+    long sum = ITER_PIPELINE(
+        ITER_VECTOR(v),
+        ITER_FILTER(is_even),
+        ITER_MAP(square),
+        ITER_REDUCE(add, 0L)
+    );
+
+    long expected = 0;
+    for (long i = 0; i < 100; i += 2)
+        expected += i * i;
+
+    pf_assert(sum == expected);
+
+    size_t count = ITER_PIPELINE(
+        ITER_VECTOR(v),
+        ITER_FILTER(BELOW_50),
+        ITER_FILTER(is_even),
+        ITER_COUNT()
+    );
+    pf_assert(count == 25);
+
+    vector(long) squares = vector_create(long, NULL);
+    pf_assert_not_null(squares);
+
+    int status = ITER_PIPELINE(
+        ITER_VECTOR(v), ITER_MAP(square), ITER_COLLECT(squares)
+    );
+    pf_assert_ok(status);
+    pf_assert(vector_length(squares) == 100);
+    pf_assert(*vector_get(squares, 9) == 81);
+
+    vector_destroy(v);
+    vector_destroy(squares);
+    return 0;
+}
+
+static long total;
+
+static void accumulate(long x) {
+    total += x;
+}
+
+int test_pipeline_array_pool(int seed, int rep) {
+    int a[] = { 1, 2, 3, 4, 5 };
+
+    total = 0;
+    ITER_PIPELINE(ITER_ARRAY(a, 5), ITER_MAP(square), ITER_EACH(accumulate));
+    pf_assert(total == 55);
+
+    pf_assert(0 == ITER_PIPELINE(ITER_ARRAY(a, 0), ITER_COUNT()));
+
+    pool(int) p = pool_create(int, NULL);
+    pf_assert_not_null(p);
+
+    int *items[100];
+    for (int i = 0; i < 100; i++) {
+        items[i] = pool_take(p);
+        pf_assert_not_null(items[i]);
+        *items[i] = i;
+    }
+
+    for (int i = 0; i < 100; i += 3)
+        pf_assert_ok(pool_give(p, items[i]));
+
+    long sum = ITER_PIPELINE(ITER_POOL(p), ITER_REDUCE(add, 0L));
+    pf_assert(sum == 4950 - 1683);
+    pf_assert(66 == ITER_PIPELINE(ITER_POOL(p), ITER_COUNT()));
+
+    pool_destroy(p);
+    return 0;
+}
+
+pf_test suite_pipeline[] = {
+    { test_pipeline_vector, "/pipeline/vector", 1 },
+    { test_pipeline_array_pool, "/pipeline/array_pool", 1 },
+    { 0 },
+};
@@ -145,6 +145,159 @@ int test_pool_iter_ref(int seed, int repetition) {
     return 0;
 }
 
+int test_pool_iter_next_n(int seed, int rep) {
+    pool(int) p = pool_create(int, NULL);
+    pf_assert_not_null(p);
+
+    int *items[200];
+    for (int i = 0; i < 200; i++) {
+        items[i] = pool_take(p);
+        pf_assert_not_null(items[i]);
+        *items[i] = i;
+    }
+
+    for (int i = 0; i < 200; i++) {
+        if (i % 7 == 3 || (i >= 60 && i < 70))
+            pf_assert_ok(pool_give(p, items[i]));
+    }
+
+    iter_t storage;
+    int out[200], *refs[200];
+    size_t count = pool_count(p);
+
+    iter(int) it = pool_iter(p, &storage);
+    pf_assert_not_null(it);
+    pf_assert(5 == iter_next_n(it, out, 5));
+    pf_assert(count - 5 == iter_next_n(it, &out[5], 200));
+    pf_assert(0 == iter_next_n(it, out, 200));
+
+    /* batches return the same items, in the same order, as `iter_next`. */
+    it = pool_iter(p, &storage);
+    for (size_t i = 0; i < count; i++) {
+        int x;
+        pf_assert_ok(iter_next(it, &x));
+        pf_assert(x == out[i]);
+        pf_assert(x % 7 != 3 && (x < 60 || x >= 70));
+    }
+
+    iter(int *) rit = pool_iter_ref(p, &storage);
+    pf_assert_not_null(rit);
+    pf_assert(count == iter_next_n(rit, refs, 200));
+
+    for (size_t i = 0; i < count; i++)
+        pf_assert(*refs[i] == out[i]);
+
+    pool_destroy(p);
+    return 0;
+}
+
+int test_pool_iter_next_span(int seed, int rep) {
+    pool(int) p = pool_create(int, NULL);
+    pf_assert_not_null(p);
+
+    int *items[150];
+    for (int i = 0; i < 150; i++) {
+        items[i] = pool_take(p);
+        pf_assert_not_null(items[i]);
+        *items[i] = i;
+    }
+
+    for (int i = 0; i < 150; i += 4)
+        pf_assert_ok(pool_give(p, items[i]));
+
+    iter_t storage;
+    const int *span;
+    size_t count, seen = 0;
+    uint64_t mask;
+    int sum = 0;
+
+    iter(int) it = pool_iter(p, &storage);
+    while (!iter_next_span(it, &span, &count, NULL)) {
+        for (size_t i = 0; i < count; i++, seen++)
+            sum += span[i];
+    }
+
+    pf_assert(seen == pool_count(p));
+
+    it = pool_iter(p, &storage);
+    while (!iter_next_span(it, &span, &count, &mask)) {
+        pf_assert(count <= 64);
+
+        for (size_t i = 0; i < count; i++) {
+            if (mask >> i & 1) {
+                pf_assert(span[i] % 4 != 0);
+                sum -= span[i];
+            }
+        }
+    }
+
+    pf_assert(sum == 0);
+    pool_destroy(p);
+    return 0;
+}
+
+int test_pool_iter_split(int seed, int rep) {
+    pool(int) p = pool_create(int, NULL);
+    pf_assert_not_null(p);
+
+    for (int i = 0; i < 1000; i++) {
+        int *item = pool_take(p);
+        pf_assert_not_null(item);
+        *item = i;
+
+        if (i % 3 == 0)
+            pf_assert_ok(pool_give(p, item));
+    }
+
+    int expected[1000], actual[1000];
+    iter_t storage, parts[3];
+    size_t count = 0;
+
+    iter(int) it = pool_iter(p, &storage);
+    size_t total = iter_next_n(it, expected, 1000);
+    pf_assert(total == pool_count(p));
+
+    /* splits the front part repeatedly, then reads parts front to back. */
+    iter(int) halves[4] = { pool_iter(p, &storage) };
+    for (size_t i = 0; i < 3; i++) {
+        halves[i + 1] = iter_split(halves[0], &parts[i]);
+        pf_assert_not_null(halves[i + 1]);
+    }
+
+    size_t hinted = 0;
+    for (size_t i = 0; i < 4; i++) {
+        size_t lower, upper;
+        iter_size_hint(halves[i], &lower, &upper);
+        pf_assert(lower == upper);
+        hinted += lower;
+    }
+
+    pf_assert(hinted == total);
+
+    count += iter_next_n(halves[0], actual, 1000);
+    for (size_t i = 3; i > 0; i--) {
+        const int *span;
+        size_t length;
+        uint64_t mask;
+
+        while (!iter_next_span(halves[i], &span, &length, &mask)) {
+            for (size_t j = 0; j < length; j++)
+                if (mask >> j & 1)
+                    actual[count++] = span[j];
+        }
+    }
+
+    pf_assert(count == total);
+    pf_assert_memcmp(expected, actual, total * sizeof(int));
+
+    pool_destroy(p);
+
+    p = pool_create(int, NULL);
+    pf_assert_null(iter_split(pool_iter(p, &storage), &parts[0]));
+    pool_destroy(p);
+    return 0;
+}
+
 int test_pool_resize(int seed, int rep) {
     pool(void *) p = pool_create(void *, NULL);
     pf_assert_not_null(p);
@@ -166,6 +319,9 @@ pf_test suite_pool[] = {
     { test_pool_index, "/pool/index", 1 },
     { test_pool_iter, "/pool/iter", 1 },
     { test_pool_iter_ref, "/pool/iter_ref", 1 },
+    { test_pool_iter_next_n, "/pool/iter_next_n", 1 },
+    { test_pool_iter_next_span, "/pool/iter_next_span", 1 },
+    { test_pool_iter_split, "/pool/iter_split", 1 },
     { test_pool_resize, "/pool/resize", 1 },
     { 0 },
 };
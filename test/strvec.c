@@ -0,0 +1,140 @@
+/*  libiter - Generic container and iterator library for C.
+
+    Copyright 2025 Predrag Jovanović
+    SPDX-FileCopyrightText: 2025 Predrag Jovanović
+    SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <iter/iter.h>
+#include <iter/strvec.h>
+#include <pf_assert.h>
+#include <pf_test.h>
+#include <string.h>
+
+int test_strvec_push(int seed, int rep) {
+    strvec_t *sv = strvec_create(NULL);
+    pf_assert_not_null(sv);
+    pf_assert(0 == strvec_length(sv));
+    pf_assert_null(strvec_get(sv, 0, NULL));
+
+    pf_assert_ok(strvec_push(sv, "hello", 5));
+    pf_assert_ok(strvec_push(sv, "", 0));
+    pf_assert_ok(strvec_push(sv, "world!", 5));
+    pf_assert(3 == strvec_length(sv));
+    pf_assert(13 == strvec_bytes_used(sv));
+
+    size_t length;
+    pf_assert(0 == strcmp(strvec_get(sv, 0, &length), "hello"));
+    pf_assert(5 == length);
+    pf_assert(0 == strcmp(strvec_get(sv, 1, &length), ""));
+    pf_assert(0 == length);
+    pf_assert(0 == strcmp(strvec_get(sv, 2, &length), "world"));
+    pf_assert(5 == length);
+
+    pf_assert(ITER_EINVAL == strvec_push(sv, NULL, 1));
+
+    /* spans are 32-bit, so the limit is checked before allocating. */
+    pf_assert(8 == sizeof(strvec_span_t));
+    pf_assert(ITER_ENOMEM == strvec_reserve(sv, 1, STRVEC_MAX_BYTES));
+    pf_assert(ITER_ENOMEM == strvec_push(sv, "", STRVEC_MAX_BYTES - 13));
+    pf_assert(3 == strvec_length(sv));
+
+    strvec_destroy(sv);
+    return 0;
+}
+
+int test_strvec_load_lines(int seed, int rep) {
+    const char text[] = "one\ntwo\n\nthree\nfour";
+    const char *lines[] = { "one", "two", "", "three", "four" };
+
+    strvec_t sv;
+    pf_assert_not_null(strvec_init(&sv, NULL));
+    pf_assert_ok(strvec_load_lines(&sv, text, sizeof(text) - 1));
+    pf_assert(5 == strvec_length(&sv));
+
+    for (size_t i = 0; i < 5; i++)
+        pf_assert(0 == strcmp(strvec_get(&sv, i, NULL), lines[i]));
+
+    pf_assert_ok(strvec_load_lines(&sv, "five\n", 5));
+    pf_assert(6 == strvec_length(&sv));
+    pf_assert(0 == strcmp(strvec_get(&sv, 5, NULL), "five"));
+
+    strvec_free(&sv);
+    return 0;
+}
+
+int test_strvec_sort(int seed, int rep) {
+    const char *words[] = { "pear", "apple", "fig", "app", "banana", "fig" };
+    const char *sorted[] = { "app", "apple", "banana", "fig", "fig", "pear" };
+
+    strvec_t *sv = strvec_create(NULL);
+    pf_assert_not_null(sv);
+
+    for (size_t r = 0; r < 8; r++)
+        for (size_t i = 0; i < 6; i++)
+            pf_assert_ok(strvec_push(sv, words[i], strlen(words[i])));
+
+    const char *bytes = strvec_get(sv, 0, NULL);
+    pf_assert_ok(strvec_sort(sv, NULL));
+    pf_assert(48 == strvec_length(sv));
+
+    for (size_t i = 0; i < 48; i++)
+        pf_assert(0 == strcmp(strvec_get(sv, i, NULL), sorted[i / 8]));
+
+    /* equal strings keep their order, bytes are never moved. */
+    const char *prev = strvec_get(sv, 0, NULL);
+    for (size_t i = 1; i < 8; i++) {
+        pf_assert(strvec_get(sv, i, NULL) > prev);
+        prev = strvec_get(sv, i, NULL);
+    }
+
+    pf_assert(bytes + strlen("pear") + 1 == strvec_get(sv, 8, NULL));
+
+    strvec_destroy(sv);
+    return 0;
+}
+
+int test_strvec_iter(int seed, int rep) {
+    strvec_t *sv = strvec_create(NULL);
+    pf_assert_not_null(sv);
+    pf_assert_ok(strvec_load_lines(sv, "a\nbb\nccc\n", 9));
+
+    iter_t tmp;
+    strvec_item_t item;
+    iter(strvec_item_t) it = strvec_iter(sv, &tmp);
+    pf_assert_not_null(it);
+
+    for (size_t i = 1; i <= 3; i++) {
+        pf_assert_ok(iter_next(it, &item));
+        pf_assert(i == item.length);
+        pf_assert(item.str == strvec_get(sv, i - 1, NULL));
+    }
+
+    pf_assert(ITER_ENODATA == iter_next(it, &item));
+    pf_assert_ok(iter_advance(it, 0));
+
+    it = strvec_iter(sv, &tmp);
+    pf_assert_ok(iter_advance(it, 2));
+    pf_assert_ok(iter_next(it, &item));
+    pf_assert(0 == strcmp(item.str, "ccc"));
+
+    it = strvec_iter(sv, &tmp);
+    pf_assert(ITER_ENODATA == iter_advance(it, 3));
+    pf_assert(ITER_ENODATA == iter_next(it, &item));
+
+    it = strvec_iter(sv, &tmp);
+    pf_assert_ok(iter_nth(it, &item, 2));
+    pf_assert(0 == strcmp(item.str, "ccc"));
+    pf_assert(ITER_ENODATA == iter_nth(it, &item, 5));
+
+    strvec_destroy(sv);
+    return 0;
+}
+
+pf_test suite_strvec[] = {
+    { test_strvec_push, "/strvec/push", 1 },
+    { test_strvec_load_lines, "/strvec/load_lines", 1 },
+    { test_strvec_sort, "/strvec/sort", 1 },
+    { test_strvec_iter, "/strvec/iter", 1 },
+    { 0 },
+};
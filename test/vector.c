@@ -144,6 +144,39 @@ int test_vector_remove(int seed, int rep) {
     return 0;
 }
 
+int test_vector_insert_remove_middle(int seed, int rep) {
+    int a[] = { 0, 1, 2, 3, 4, 5, 6, 7 }, b[] = { 10, 11, 12 };
+    int c[] = { 0, 1, 10, 11, 12, 2, 3, 4, 5, 6, 7 };
+    vector(int) v = vector_from_array(a, 8, NULL);
+    pf_assert_not_null(v);
+
+    /* the shifted range overlaps its destination. */
+    pf_assert_ok(vector_insert(v, b, 2, 3));
+    pf_assert(vector_length(v) == 11);
+    pf_assert_memcmp(c, vector_items(v), sizeof(c));
+
+    pf_assert_ok(vector_remove(v, 2, 3));
+    pf_assert(vector_length(v) == 8);
+    pf_assert_memcmp(a, vector_items(v), sizeof(a));
+
+    /* removing all but the last item still moves it into place. */
+    pf_assert_ok(vector_remove(v, 1, 6));
+    pf_assert(vector_length(v) == 2);
+    pf_assert(0 == *vector_get(v, 0) && 7 == *vector_get(v, 1));
+
+    char d[] = { 'a', 'b', 'c', 'd' };
+    vector(char) w = vector_from_array(d, 4, NULL);
+    pf_assert_not_null(w);
+
+    pf_assert_ok(vector_remove(w, 1, 2));
+    pf_assert(vector_length(w) == 2);
+    pf_assert('a' == *vector_get(w, 0) && 'd' == *vector_get(w, 1));
+
+    vector_destroy(w);
+    vector_destroy(v);
+    return 0;
+}
+
 int test_vector_from_array(int seed, int rep) {
     int a[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
     vector(int) v1 = vector_from_array(a, 10, NULL);
@@ -299,6 +332,7 @@ int test_vector_iter(int seed, int rep) {
     pf_assert_not_null(v2);
 
     pf_assert(5 == vector_length(v2));
+    pf_assert(vector_capacity(v1) == vector_capacity(v2));
     pf_assert_memcmp(vector_items(v1), vector_items(v2), sizeof(int) * 5);
     pf_assert(ITER_ENODATA == iter_next(it, &out));
 
@@ -387,7 +421,7 @@ int test_vector_map(int seed, int rep) {
 
 int test_vector_find(int seed, int rep) {
     int a[] = { 0, 1, 2, 2, 1 };
-    vector(int) v = vector_from_array(a, 10, NULL);
+    vector(int) v = vector_from_array(a, 5, NULL);
     pf_assert_not_null(v);
 
     pf_assert(vector_find(v, &a[0], NULL) == vector_get(v, 0));
@@ -425,15 +459,446 @@ int test_vector_sort(int seed, int rep) {
     return 0;
 }
 
+struct keyed {
+    int key;
+    int order;
+};
+
+static int compare_keyed(const void *lhs, const void *rhs, size_t size) {
+    return ((const struct keyed *)lhs)->key - ((const struct keyed *)rhs)->key;
+}
+
+int test_vector_sort_with_buffer(int seed, int rep) {
+    struct keyed scratch[300];
+    size_t lengths[] = { 0, 1, 7, 300 };
+
+    for (size_t l = 0; l < 4; l++) {
+        vector(struct keyed) v = vector_create(struct keyed, NULL);
+        pf_assert_not_null(v);
+
+        for (int i = 0; i < 600; i++) {
+            struct keyed item = { (i * 7919) % 37, i };
+            pf_assert_ok(vector_push(v, &item, 1));
+        }
+
+        pf_assert_ok(
+            vector_sort_with_buffer(v, compare_keyed, scratch, lengths[l])
+        );
+
+        for (size_t i = 1; i < 600; i++) {
+            struct keyed *prev = vector_get(v, i - 1), *item = vector_get(v, i);
+            pf_assert(prev->key <= item->key);
+            pf_assert(prev->key < item->key || prev->order < item->order);
+        }
+
+        vector_destroy(v);
+    }
+
+    vector(int) v = vector_create(int, NULL);
+    pf_assert(
+        ITER_EINVAL
+        == vector_sort_with_buffer(v, compare_int, (int *)NULL, 1)
+    );
+
+    vector_destroy(v);
+    return 0;
+}
+
+int test_vector_unique(int seed, int rep) {
+    int a[] = { 1, 1, 2, 3, 3, 3, 4, 5, 6, 7, 8, 9, 10, 11, 11, 12, 13, 13 };
+    int b[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
+    vector(int) v = vector_from_array(a, 18, NULL);
+    pf_assert_not_null(v);
+
+    pf_assert(13 == vector_unique(v, NULL));
+    pf_assert(13 == vector_length(v));
+    pf_assert_memcmp(b, vector_items(v), sizeof(b));
+
+    vector_clear(v);
+    pf_assert_ok(vector_push(v, (int *)a, 18));
+    pf_assert(13 == vector_unique(v, compare_int));
+    pf_assert_memcmp(b, vector_items(v), sizeof(b));
+
+    vector_destroy(v);
+
+    char c[64], d[64];
+    size_t length = 0;
+    for (size_t i = 0; i < 64; i++) {
+        c[i] = (char)(i / 3 + i % 2 * 100);
+        if (i == 0 || c[i] != c[i - 1])
+            d[length++] = c[i];
+    }
+
+    vector(char) chars = vector_from_array(c, 64, NULL);
+    pf_assert_not_null(chars);
+    pf_assert(length == vector_unique(chars, NULL));
+    pf_assert_memcmp(d, vector_items(chars), length);
+
+    vector_destroy(chars);
+    return 0;
+}
+
+int test_vector_dedup_unsorted(int seed, int rep) {
+    int a[] = { 5, 1, 5, 2, 1, 3, 2, 4, 5 };
+    int b[] = { 5, 1, 2, 3, 4 };
+    vector(int) v = vector_from_array(a, 9, NULL);
+    pf_assert_not_null(v);
+
+    pf_assert(5 == vector_dedup_unsorted(v, NULL));
+    pf_assert(5 == vector_length(v));
+    pf_assert_memcmp(b, vector_items(v), sizeof(b));
+
+    pf_assert(5 == vector_dedup_unsorted(v, NULL));
+    pf_assert(0 == vector_dedup_unsorted((vector(int))NULL, NULL));
+
+    vector_destroy(v);
+    return 0;
+}
+
+int test_vector_merge_k(int seed, int rep) {
+    int a[] = { 1, 4, 4, 10 }, b[] = { 2, 4, 8 }, c[] = { 0, 3, 9 };
+    int d[] = { 0, 1, 2, 3, 4, 4, 4, 8, 9, 10 };
+
+    vector(int) inputs[] = {
+        vector_from_array(a, 4, NULL),
+        vector_from_array(b, 3, NULL),
+        vector_create(int, NULL),
+        vector_from_array(c, 3, NULL),
+    };
+
+    vector(int) out = vector_create(int, NULL);
+    pf_assert_not_null(out);
+
+    pf_assert_ok(vector_merge_k(out, inputs, 4, compare_int));
+    pf_assert(10 == vector_length(out));
+    pf_assert_memcmp(d, vector_items(out), sizeof(d));
+
+    pf_assert(ITER_EINVAL == vector_merge_k(out, inputs, 4, NULL));
+    pf_assert(ITER_EINVAL == vector_merge_k(inputs[0], inputs, 4, compare_int));
+
+    /* wrapped vectors without an allocator use the default for scratch. */
+    int buffer[16];
+    vector(int) wrapped = vector_wrap(buffer, 16, NULL);
+    pf_assert_not_null(wrapped);
+
+    vector_clear(wrapped);
+    pf_assert_ok(vector_merge_k(wrapped, inputs, 4, compare_int));
+    pf_assert(10 == vector_length(wrapped));
+    pf_assert_memcmp(d, vector_items(wrapped), sizeof(d));
+
+    for (int i = 0; i < 4; i++)
+        vector_destroy(inputs[i]);
+
+    vector_destroy(wrapped);
+    vector_destroy(out);
+    return 0;
+}
+
+int test_vector_slice(int seed, int rep) {
+    int a[] = { 0, 1, 2, 3, 4, 5 };
+    vector(int) v = vector_from_array(a, 6, NULL);
+    pf_assert_not_null(v);
+
+    vector(int) s = vector_slice(v, 2, 5);
+    pf_assert_not_null(s);
+    pf_assert(3 == vector_length(s));
+    pf_assert(vector_items(s) == vector_get(v, 2));
+
+    vector(int) t = vector_slice(s, 1, 3);
+    pf_assert_not_null(t);
+    pf_assert(*vector_get(t, 0) == 3);
+    pf_assert(*vector_get(t, 1) == 4);
+
+    pf_assert_null(vector_slice(v, 4, 7));
+    pf_assert_null(vector_slice(v, 3, 2));
+
+    vector_destroy(v);
+    pf_assert(*vector_get(s, 0) == 2);
+    pf_assert(*vector_get(t, 1) == 4);
+
+    vector_destroy(s);
+    vector_destroy(t);
+    return 0;
+}
+
+int test_vector_unshare(int seed, int rep) {
+    int a[] = { 0, 1, 2, 3, 4, 5 };
+    int b[] = { 1, 9, 2, 3 };
+    vector(int) v = vector_from_array(a, 6, NULL);
+    pf_assert_not_null(v);
+
+    vector(int) s = vector_slice(v, 1, 4);
+    pf_assert_not_null(s);
+
+    int x = 9;
+    pf_assert_ok(vector_insert(s, &x, 1, 1));
+    pf_assert(vector_items(s) != vector_get(v, 1));
+    pf_assert_memcmp(b, vector_items(s), sizeof(b));
+    pf_assert_memcmp(a, vector_items(v), sizeof(a));
+    vector_destroy(s);
+
+    s = vector_slice(v, 2, 4);
+    pf_assert_not_null(s);
+    vector_destroy(v);
+
+    /* the last owner takes the buffer over without copying. */
+    int *items = vector_items(s);
+    pf_assert_ok(vector_unshare(s));
+    pf_assert(vector_capacity(s) >= 6);
+    pf_assert(*vector_get(s, 0) == 2);
+    pf_assert(*vector_get(s, 1) == 3);
+    pf_assert(vector_items(s) == items - 2);
+
+    vector_destroy(s);
+    return 0;
+}
+
+int test_vector_with_alignment(int seed, int rep) {
+    vector(char) v = vector_with_alignment(char, 3, 64, NULL);
+    pf_assert_not_null(v);
+    pf_assert(vector_capacity(v) >= 3);
+    pf_assert(0 == (uintptr_t)vector_items(v) % 64);
+
+    for (char i = 0; i < 100; i++) {
+        pf_assert_ok(vector_push(v, &i, 1));
+        pf_assert(0 == (uintptr_t)vector_items(v) % 64);
+    }
+
+    pf_assert_ok(vector_shrink(v));
+    pf_assert(0 == (uintptr_t)vector_items(v) % 64);
+
+    for (char i = 0; i < 100; i++)
+        pf_assert(i == *vector_get(v, i));
+
+    vector(char) s = vector_slice(v, 1, 10);
+    pf_assert_not_null(s);
+    pf_assert_ok(vector_remove(v, 0, 1));
+    pf_assert(0 == (uintptr_t)vector_items(v) % 64);
+    pf_assert(1 == *vector_get(s, 0));
+    vector_destroy(s);
+
+    pf_assert_null(vector_unwrap(v));
+    pf_assert_null(vector_with_alignment(char, 1, 24, NULL));
+
+    vector_destroy(v);
+    return 0;
+}
+
+int test_vector_shuffle(int seed, int rep) {
+    iter_rng_t rng;
+    iter_rng_seed(&rng, (uint64_t)seed);
+
+    vector(int) v = vector_create(int, NULL);
+    pf_assert_not_null(v);
+
+    for (int i = 0; i < 1000; i++)
+        pf_assert_ok(vector_push(v, &i, 1));
+
+    pf_assert_ok(vector_shuffle(v, &rng));
+    pf_assert(vector_length(v) == 1000);
+
+    int moved = 0;
+    char seen[1000] = { 0 };
+    for (int i = 0; i < 1000; i++) {
+        int x = *vector_get(v, i);
+        pf_assert(x >= 0 && x < 1000 && !seen[x]);
+        seen[x] = 1;
+        moved += x != i;
+    }
+
+    pf_assert(moved > 900);
+
+    /* the same seed gives the same permutation. */
+    vector(int) w = vector_clone(v, NULL);
+    iter_rng_t a, b;
+    iter_rng_seed(&a, 42);
+    iter_rng_seed(&b, 42);
+    pf_assert_ok(vector_shuffle(v, &a));
+    pf_assert_ok(vector_shuffle(w, &b));
+    pf_assert_memcmp(vector_items(v), vector_items(w), 1000 * sizeof(int));
+
+    vector_destroy(v);
+    vector_destroy(w);
+    return 0;
+}
+
+int test_vector_sample_k(int seed, int rep) {
+    iter_rng_t rng;
+    iter_rng_seed(&rng, (uint64_t)seed);
+
+    vector(int) v = vector_create(int, NULL);
+    vector(int) s = vector_create(int, NULL);
+    pf_assert_not_null(v);
+    pf_assert_not_null(s);
+
+    for (int i = 0; i < 100; i++)
+        pf_assert_ok(vector_push(v, &i, 1));
+
+    int x = -1;
+    pf_assert_ok(vector_push(s, &x, 1));
+    pf_assert_ok(vector_sample_k(s, v, 30, &rng));
+    pf_assert(vector_length(s) == 31);
+    pf_assert(*vector_get(s, 0) == -1);
+
+    char seen[100] = { 0 };
+    for (size_t i = 1; i < 31; i++) {
+        int y = *vector_get(s, i);
+        pf_assert(y >= 0 && y < 100 && !seen[y]);
+        seen[y] = 1;
+    }
+
+    for (int i = 0; i < 100; i++)
+        pf_assert(*vector_get(v, i) == i);
+
+    vector_clear(s);
+    pf_assert_ok(vector_sample_k(s, v, 100, &rng));
+    pf_assert(vector_length(s) == 100);
+    pf_assert(vector_sample_k(s, v, 101, &rng) == ITER_EINVAL);
+    pf_assert(vector_sample_k(v, v, 1, &rng) == ITER_EINVAL);
+
+    vector_destroy(v);
+    vector_destroy(s);
+    return 0;
+}
+
+static int is_odd(const void *item, void *user) {
+    return *(const int *)item % 2;
+}
+
+int test_iter_reservoir_sample(int seed, int rep) {
+    iter_rng_t rng;
+    iter_rng_seed(&rng, (uint64_t)seed);
+
+    int items[10000];
+    for (int i = 0; i < 10000; i++)
+        items[i] = i;
+
+    vector(int) s = vector_create(int, NULL);
+    pf_assert_not_null(s);
+
+    iter_t storage, filtered;
+    char seen[10000] = { 0 };
+
+    pf_assert_ok(iter_reservoir_sample(
+        s, iter_from_array(&storage, items, 10000), 20, &rng
+    ));
+    pf_assert(vector_length(s) == 20);
+
+    for (size_t i = 0; i < 20; i++) {
+        int y = *vector_get(s, i);
+        pf_assert(y >= 0 && y < 10000 && !seen[y]);
+        seen[y] = 1;
+    }
+
+    /* every item is picked with probability k / n = 0.1. */
+    size_t counts[50] = { 0 };
+    for (int r = 0; r < 2000; r++) {
+        vector_clear(s);
+        pf_assert_ok(iter_reservoir_sample(
+            s, iter_from_array(&storage, items, 50), 5, &rng
+        ));
+        pf_assert(vector_length(s) == 5);
+
+        for (size_t i = 0; i < 5; i++)
+            counts[*vector_get(s, i)]++;
+    }
+
+    for (size_t i = 0; i < 50; i++)
+        pf_assert(counts[i] > 120 && counts[i] < 280);
+
+    /* sources without a known size are skipped item by item. */
+    vector_clear(s);
+    pf_assert_ok(iter_reservoir_sample(
+        s,
+        iter_filter(&filtered, iter_from_array(&storage, items, 1000),
+                    is_odd, NULL),
+        10, &rng
+    ));
+    pf_assert(vector_length(s) == 10);
+    for (size_t i = 0; i < 10; i++)
+        pf_assert(*vector_get(s, i) % 2 == 1);
+
+    vector_clear(s);
+    pf_assert_ok(iter_reservoir_sample(
+        s, iter_from_array(&storage, items, 3), 10, &rng
+    ));
+    pf_assert(vector_length(s) == 3);
+
+    vector_destroy(s);
+    return 0;
+}
+
+int test_iter_top_k(int seed, int rep) {
+    iter_rng_t rng;
+    iter_rng_seed(&rng, (uint64_t)seed);
+
+    vector(int) v = vector_create(int, NULL);
+    vector(int) top = vector_create(int, NULL);
+    pf_assert_not_null(v);
+    pf_assert_not_null(top);
+
+    for (int i = 0; i < 5000; i++) {
+        int x = (int)iter_rng_bounded(&rng, 1000);
+        pf_assert_ok(vector_push(v, &x, 1));
+    }
+
+    iter_t storage;
+    int x = -1;
+    pf_assert_ok(vector_push(top, &x, 1));
+    pf_assert_ok(iter_top_k(top, vector_iter(v, &storage), 100, compare_int));
+    pf_assert(vector_length(top) == 101);
+    pf_assert(*vector_get(top, 0) == -1);
+
+    pf_assert_ok(vector_sort(v, compare_int));
+    for (size_t i = 0; i < 100; i++)
+        pf_assert(*vector_get(top, i + 1) == *vector_get(v, i));
+
+    vector_clear(top);
+    pf_assert_ok(iter_top_k(top, vector_iter(v, &storage), 9000, compare_int));
+    pf_assert(vector_length(top) == 5000);
+    pf_assert(vector_is_sorted(top, compare_int) == ITER_TRUE);
+
+    vector_clear(top);
+    pf_assert_ok(iter_top_k(top, vector_iter(v, &storage), 0, compare_int));
+    pf_assert(vector_length(top) == 0);
+
+    vector_destroy(v);
+    vector_destroy(top);
+    return 0;
+}
+
+int test_vector_apply_permutation(int seed, int rep) {
+    int a[] = { 10, 11, 12, 13, 14, 15 };
+    int b[] = { 13, 10, 15, 11, 12, 14 };
+    size_t perm[] = { 3, 0, 5, 1, 2, 4 };
+    size_t bad[] = { 3, 0, 5, 1, 3, 4 };
+    size_t out[] = { 3, 0, 5, 1, 6, 4 };
+
+    vector(int) v = vector_from_array(a, 6, NULL);
+    pf_assert_not_null(v);
+
+    pf_assert(vector_apply_permutation(v, bad) == ITER_EINVAL);
+    pf_assert(vector_apply_permutation(v, out) == ITER_EINVAL);
+    pf_assert_memcmp(a, vector_items(v), sizeof(a));
+
+    pf_assert_ok(vector_apply_permutation(v, perm));
+    pf_assert_memcmp(b, vector_items(v), sizeof(b));
+
+    vector_destroy(v);
+    return 0;
+}
+
 pf_test suite_vector[] = {
     { test_vector_init, "/vector/init", 1 },
     { test_vector_create, "/vector/create", 1 },
     { test_vector_wrap, "/vector/wrap", 1 },
     { test_vector_resize, "/vector/resize", 1 },
     { test_vector_reserve, "/vector/reserve", 1 },
+    { test_vector_with_alignment, "/vector/with_alignment", 1 },
     { test_vector_insert, "/vector/insert", 1 },
     { test_vector_try_insert, "/vector/try_insert", 1 },
     { test_vector_remove, "/vector/remove", 1 },
+    { test_vector_insert_remove_middle, "/vector/insert_remove_middle", 1 },
     { test_vector_from_array, "/vector/from_array", 1 },
     { test_vector_clone, "/vector/clone", 1 },
     { test_vector_index, "/vector/index", 1 },
@@ -448,5 +913,16 @@ pf_test suite_vector[] = {
     { test_vector_map, "/vector/map", 1 },
     { test_vector_find, "/vector/find", 1 },
     { test_vector_sort, "/vector/sort", 1 },
+    { test_vector_sort_with_buffer, "/vector/sort_with_buffer", 1 },
+    { test_vector_unique, "/vector/unique", 1 },
+    { test_vector_dedup_unsorted, "/vector/dedup_unsorted", 1 },
+    { test_vector_merge_k, "/vector/merge_k", 1 },
+    { test_vector_slice, "/vector/slice", 1 },
+    { test_vector_unshare, "/vector/unshare", 1 },
+    { test_vector_shuffle, "/vector/shuffle", 1 },
+    { test_vector_sample_k, "/vector/sample_k", 1 },
+    { test_iter_reservoir_sample, "/vector/reservoir_sample", 1 },
+    { test_iter_top_k, "/vector/top_k", 1 },
+    { test_vector_apply_permutation, "/vector/apply_permutation", 1 },
     { 0 },
 };